@@ -20,18 +20,31 @@
  * 
  */
 
-#include <GL/glut.h>
-#include <wx/msw/winundef.h>
+#include <vector>
 
 #include "Enums.h"
 #include "Frame.h"
 #include "Config.h"
+#include "Console.h"
 
 #include "App.h"
 
+#if !defined(DEBUG_BUILD) && !defined(__WXMSW__)
+int main(int argc, char** argv)
+{
+	if(argc > 1 && Console::isConsoleMode(wxString(argv[1], wxConvLocal)))
+	{
+		return Console::main(argc, argv);
+	}
+	return wxEntry(argc, argv);
+}
+#endif
+
 App::App()
 {
-	/* Nothing to do. */
+	frame = 0;
+	batchMode = false;
+	batchResult = 0;
 }
 
 App::~App()
@@ -42,7 +55,20 @@ App::~App()
 bool App::OnInit()
 {
 #ifndef DEBUG_BUILD
-	glutInit(&argc, (char**)argv);
+	// On Windows wx supplies the entry point, so the console modes start here.
+	if(argc > 1 && Console::isConsoleMode(argv[1]))
+	{
+		batchMode = true;
+		wxInitAllImageHandlers();
+		std::vector<wxString> args;
+		for(int i = 1; i < argc; i++)
+		{
+			args.push_back(argv[i]);
+		}
+		Console console(args);
+		batchResult = console.run();
+		return true;
+	}
 	frame = new Frame( _T("MIPS-Datapath"), wxPoint(50,50), wxSize(450,340) );
     frame->Show(TRUE);
  	SetTopWindow(frame);
@@ -50,3 +76,12 @@ bool App::OnInit()
     return TRUE;
 #endif
 }
+
+int App::OnRun()
+{
+	if(batchMode)
+	{
+		return batchResult;
+	}
+	return wxApp::OnRun();
+}
@@ -33,12 +33,19 @@ public:
 	App();
 	virtual ~App();
 	virtual bool OnInit();
+	virtual int OnRun();
 private:
 	Frame *frame;
+	bool batchMode;
+	int batchResult;
 };
 #ifndef DEBUG_BUILD
+#ifdef __WXMSW__
 IMPLEMENT_APP(App)
+#else
+// main() in App.cc starts the console modes without the GUI app.
+IMPLEMENT_APP_NO_MAIN(App)
+#endif
 #endif
 
 #endif /*APP_H_*/
-
@@ -0,0 +1,117 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include "Config.h"
+#include "Model.h"
+#include "ThreadPool.h"
+
+#include "BatchRunner.h"
+
+BatchRunner::BatchRunner(Layout layout, luint maxCycles, uint numThreads)
+	: pool(std::make_unique<ThreadPool>(numThreads))
+{
+	this->layout = layout;
+	this->maxCycles = maxCycles;
+	simulationMode = SIM_COMPILED;
+	// Read the config file now, the models only look values up in it.
+	Config::Instance();
+}
+
+BatchRunner::~BatchRunner()
+{
+	/* Nothing to do. */
+}
+
+void BatchRunner::run()
+{
+	results.clear();
+	results.resize(files.size());
+	for(uint i = 0; i < files.size(); i++)
+	{
+		BatchResult& result = results[i];
+		result.file = files[i];
+		pool->submit([this, &result]{ runProgram(result); });
+	}
+	pool->wait();
+}
+
+void BatchRunner::runProgram(BatchResult& result)
+{
+	result.valid = false;
+	result.finished = false;
+	result.cycles = 0;
+	Model processor;
+	processor.setSimulationMode(simulationMode);
+	// Nothing steps back through a batch run.
+	processor.getHistory().setMaxBytes(0);
+	processor.resetup(layout);
+	if(processor.loadProgram(result.file))
+	{
+		result.valid = true;
+		luint end = processor.getProgramEnd();
+		result.cycles = processor.runToEnd(end, maxCycles);
+		result.finished = processor.atEnd(end);
+		result.counters = processor.getCounters();
+	}
+	for(uint i = 0; i < Model::MAX_REGISTERS; i++)
+	{
+		result.registers.push_back(processor.getMemoryData(ID_REGISTER_LIST, i));
+	}
+	for(uint i = 0; i < Model::MAX_DATA; i++)
+	{
+		result.data.push_back(processor.getMemoryData(ID_DATA_LIST, i));
+	}
+}
+
+void BatchRunner::writeReport(std::ostream& out)
+{
+	for(auto&& i : results)
+	{
+		out << (const char*)i.file.mb_str() << ": ";
+		if(!i.valid)
+		{
+			out << "parse errors\n";
+			continue;
+		}
+		out << (i.finished ? "finished" : "cycle limit reached") << " after " << i.cycles << " cycles\n";
+		out << "  registers:";
+		for(auto&& r : i.registers)
+		{
+			out << " " << r;
+		}
+		out << "\n  counters:";
+		for(uint c = COUNTER_MIN; c < COUNTER_MAX; c++)
+		{
+			out << " " << PerformanceCounters::getName((Counter)c) << "=" << i.counters.get((Counter)c);
+		}
+		out << " cpi=" << i.counters.getCPI();
+		out << "\n  data:";
+		for(uint d = 0; d < i.data.size(); d++)
+		{
+			if(i.data[d] != 0)
+			{
+				out << " " << d << "=" << i.data[d];
+			}
+		}
+		out << "\n";
+	}
+}
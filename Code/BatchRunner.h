@@ -0,0 +1,75 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef BATCHRUNNER_H_
+#define BATCHRUNNER_H_
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include <wx/string.h>
+
+#include "Types.h"
+#include "Enums.h"
+#include "PerformanceCounters.h"
+
+class ThreadPool;
+
+// Final state of one program run by BatchRunner.
+struct BatchResult
+{
+	wxString file;
+	bool valid;			// The file was read and parsed without errors.
+	bool finished;		// The program ran past its last instruction within the cycle limit.
+	luint cycles;		// Clock cycles, not Model::step() calls.
+	std::vector<luint> registers;
+	std::vector<luint> data;
+	PerformanceCounters counters;
+};
+
+// Runs many programs, each in its own Model on a ThreadPool. A program is
+// run until it has run past its last instruction, as Model::atEnd() finds
+// it, or for the cycle limit in clock cycles.
+class BatchRunner
+{
+	public:
+		BatchRunner(Layout layout = LAYOUT_SIMPLE, luint maxCycles = DEFAULT_MAX_CYCLES, uint numThreads = 0);
+		~BatchRunner();
+		void addFile(wxString file){ files.push_back(file); };
+		void setSimulationMode(SimulationMode mode){ simulationMode = mode; };
+		// Run every added file and wait for them all to finish.
+		void run();
+		const std::vector<BatchResult>& getResults(){ return results; };
+		void writeReport(std::ostream& out);
+		static const luint DEFAULT_MAX_CYCLES = 1000000;
+	private:
+		void runProgram(BatchResult& result);
+		std::unique_ptr<ThreadPool> pool;
+		std::vector<wxString> files;
+		std::vector<BatchResult> results;
+		Layout layout;
+		SimulationMode simulationMode;
+		luint maxCycles;
+};
+
+#endif /*BATCHRUNNER_H_*/
@@ -23,13 +23,10 @@
 #ifndef COLOR_H_
 #define COLOR_H_
 
-#include <GL/glut.h>
-#include <wx/msw/winundef.h>
-
 struct Color
 {
 	Color(){ init = false; };
-	Color(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+	Color(float r, float g, float b, float a)
 	{ 
 		// Set initial values.
 		this->c[0] = r; 
@@ -38,7 +35,7 @@ struct Color
 		this->c[3] = a;
 		init = true;
 	}
-	GLfloat c[4];
+	float c[4];
 	bool init;
 };
 
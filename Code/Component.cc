@@ -21,11 +21,13 @@
  */
  
 #include <exception>
+#include <cstring>
 
 #include "Link.h"
 #include "Coord.h"
 #include "Side.h"
 #include "Color.h"
+#include "Model.h"
 
 #include "Component.h"
 
@@ -38,11 +40,7 @@ class InvalidInputException : public std::exception
 
 } InvalidInputEx;
 
-int Component::count = 0;
-
-uint Component::pipelineCycle = 0;
-
-std::vector<Color> Component::activeLinkColors =
+const std::vector<Color> Component::activeLinkColors =
 {
 	Color(1.0, 0.0, 0.0, 1.0),
 	Color(0.0, 1.0, 0.0, 1.0),
@@ -50,40 +48,35 @@ std::vector<Color> Component::activeLinkColors =
 	Color(0.0, 0.0, 1.0, 1.0),
 	Color(0.0, 1.0, 1.0, 1.0)
 };
-std::map<configName, Color> Component::colours;
-bool Component::dataLinesBold = true;
-bool Component::highlightSingleInstruction = true;
-int Component::currentInstruction = 0;
-const GLfloat Component::DATA_LINE_WIDTH = 2.0;
-const GLfloat Component::THIN_DATA_LINE_WIDTH = 1.0;
+const float Component::DATA_LINE_WIDTH = 2.0;
+const float Component::THIN_DATA_LINE_WIDTH = 1.0;
 const double Component::PI = 3.14159265358979323;
-		
-void Component::setActiveLinkColour(wxColour colour, uint stage)
+
+ComponentContext::ComponentContext()
 {
-	if(0 <= stage && stage < 5)
-	{
-		switch(stage)
-		{
-			case 0:
-			setColour(STAGE1_COLOUR, colour);
-			break;
-			case 1:
-			setColour(STAGE2_COLOUR, colour);
-			break;
-			case 2:
-			setColour(STAGE3_COLOUR, colour);
-			break;
-			case 3:
-			setColour(STAGE4_COLOUR, colour);
-			break;
-			case 4:
-			setColour(STAGE5_COLOUR, colour);
-			break;			
-		}
-	}
+	pipelineCycle = 0;
+	currentInstruction = 0;
+	dataLinesBold = true;
+	highlightSingleInstruction = true;
+	detailLevel = DETAIL_FULL;
+	componentCount = 0;
+	linkCount = 0;
+	Config &c = Config::Instance();
+	setColour(COMPONENT_COLOUR, c.getColour(COMPONENT_COLOUR));
+	setColour(PIPEREG_COLOUR, c.getColour(PIPEREG_COLOUR));
+	setColour(STAGE1_COLOUR, c.getColour(STAGE1_COLOUR));
+	setColour(STAGE2_COLOUR, c.getColour(STAGE2_COLOUR));
+	setColour(STAGE3_COLOUR, c.getColour(STAGE3_COLOUR));
+	setColour(STAGE4_COLOUR, c.getColour(STAGE4_COLOUR));
+	setColour(STAGE5_COLOUR, c.getColour(STAGE5_COLOUR));
+	setColour(TEXT_COLOUR, c.getColour(TEXT_COLOUR));
+	setColour(BORDER_COLOUR, c.getColour(BORDER_COLOUR));
+	setColour(BACKGROUND_COLOUR, c.getColour(BACKGROUND_COLOUR));
+	setColour(LINK_COLOUR, c.getColour(LINK_COLOUR));
+	setColour(FADE_COLOUR, c.getColour(FADE_COLOUR));
 }
 
-Color Component::getActiveLinkColour(uint stage)
+Color ComponentContext::getActiveLinkColour(uint stage)
 {
 	if(0 <= stage && stage < 5)
 	{
@@ -104,19 +97,50 @@ Color Component::getActiveLinkColour(uint stage)
 	return Color(255, 255, 255, 255);
 }
 
-wxColour Component::getwxColour(configName name)
+wxColour ComponentContext::getwxColour(configName name)
 {
 	float charM = 255.0;
 	Color colour = colours[name];
 	return wxColour(int(colour.c[0] * charM), int(colour.c[1] * charM), int(colour.c[2] * charM), 255);
 }
 
-void Component::setColour(configName name, wxColour colour)
+void ComponentContext::setColour(configName name, wxColour colour)
 {
 	float charM = 255.0;
 	colours[name] = Color(colour.Red() / charM, colour.Green() / charM, colour.Blue() / charM, 1.0);
 }
 
+void ComponentContext::incrementPipelineCycle()
+{ 
+	pipelineCycle = (pipelineCycle + 4) % 5; 
+	// Increment current instruction for highlighting if it is already valid.
+	if(currentInstruction != -1)
+	{
+		currentInstruction++;
+	}
+	// If the current instruction goes outside the correct range, make it invalid.
+	if(currentInstruction > 4)
+	{
+		currentInstruction = -1;
+	}
+}
+
+void ComponentContext::setCurrentInstruction(int instr)
+{ 
+	// If instr is -1 it means no instruction should be highlighted therefore set
+	// currentInstruction to -1.
+	if(instr == -1)
+	{
+		currentInstruction = instr;
+	}
+	else
+	{
+		// To make sure the correct instruction is highlighted we have to 
+		// effectively increment the val inputted by pipelineCycle.
+		currentInstruction = (10 - instr - pipelineCycle) % 5; 
+	}
+}
+
 void Component::preStep()
 {
 	// Darken link color for this component
@@ -138,6 +162,24 @@ void Component::preStep()
 	}
 }
 
+void Component::saveState(std::vector<luint>& state)
+{
+	uint colour;
+	std::memcpy(&colour, &oldActiveLinkColor, sizeof(colour));
+	state.push_back(((luint)colour << 2) | (preActive ? 1 : 0) | (activeOutputs ? 2 : 0));
+}
+
+void Component::loadState(const luint*& state)
+{
+	luint word = *state++;
+	preActive = (word & 1) != 0;
+	activeOutputs = (word & 2) != 0;
+	uint colour = (uint)(word >> 2);
+	std::memcpy(&oldActiveLinkColor, &colour, sizeof(colour));
+	// Stepping an unchanged component again is harmless, missing a change is not.
+	dirty = true;
+}
+
 Color Component::scaleColors(Color cMin, Color cMax, double proportion)
 {
 	double r = (cMax.c[0] - cMin.c[0]) * proportion + cMin.c[0];
@@ -164,32 +206,24 @@ Component::Component(double x, double y, double w, double h, wxString name, Comp
 	
 	oldActiveLinkColor = 1.0;
 	preActive = false;
-	ID = count++;	
+	ID = -1;
+	context = 0;
+	netValues = 0;
+	netPorts = 0;
+	numNetPorts = 0;
+	dirty = true;
 	pipelineStage = 0;
-	
-	Config &c = Config::Instance();
-	setColour(COMPONENT_COLOUR, c.getColour(COMPONENT_COLOUR));
-	setColour(PIPEREG_COLOUR, c.getColour(PIPEREG_COLOUR));
-	setColour(STAGE1_COLOUR, c.getColour(STAGE1_COLOUR));
-	setColour(STAGE2_COLOUR, c.getColour(STAGE2_COLOUR));
-	setColour(STAGE3_COLOUR, c.getColour(STAGE3_COLOUR));
-	setColour(STAGE4_COLOUR, c.getColour(STAGE4_COLOUR));
-	setColour(STAGE5_COLOUR, c.getColour(STAGE5_COLOUR));
-	setColour(TEXT_COLOUR, c.getColour(TEXT_COLOUR));
-	setColour(BORDER_COLOUR, c.getColour(BORDER_COLOUR));
-	setColour(BACKGROUND_COLOUR, c.getColour(BACKGROUND_COLOUR));
-	setColour(LINK_COLOUR, c.getColour(LINK_COLOUR));
-	setColour(FADE_COLOUR, c.getColour(FADE_COLOUR));
-	
-	setActiveLinkColour(c.getColour(STAGE1_COLOUR), 0);
-	setActiveLinkColour(c.getColour(STAGE2_COLOUR), 1);
-	setActiveLinkColour(c.getColour(STAGE3_COLOUR), 2);
-	setActiveLinkColour(c.getColour(STAGE4_COLOUR), 3);
-	setActiveLinkColour(c.getColour(STAGE5_COLOUR), 4);
-	if(!(fillColorMin.init))
+}
+
+void Component::setContext(ComponentContext* context)
+{
+	this->context = context;
+	ID = context->newComponentID();
+	for(auto&& i : linkList)
 	{
-		this->fillColorMin = colours[COMPONENT_COLOUR];
+		i.second->setID(context->newLinkID());
 	}
+	resetColour();
 }
 
 void Component::setActive(bool active)
@@ -290,58 +324,53 @@ void Component::setLinkControl(bool c, int l)
 	linkList[l]->setControl(c); 
 }
 
-void Component::position()
+void Component::position(Renderer& renderer)
 {
-	glTranslatef(pos.x, pos.y, 0.0);
-	glScalef(w, h, 1.0);
+	renderer.translate(pos.x, pos.y);
+	renderer.scale(w, h);
 }
 
-void Component::drawBackground()
+void Component::drawBackground(Renderer& renderer, ComponentContext& context)
 {
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
-	glColor4fv(colours[BACKGROUND_COLOUR].c);
-	glBegin(GL_TRIANGLE_STRIP);
-	glVertex2f(-1000, -1000);
-	glVertex2f(2000, -1000);
-	glVertex2f(-1000, 2000);
-	glVertex2f(2000, 2000);
-	glEnd();
-	glPopMatrix();
-	glPopAttrib();
+	renderer.pushState();
+	renderer.setColour(context.getColour(BACKGROUND_COLOUR));
+	renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
+	renderer.vertex(-1000, -1000);
+	renderer.vertex(2000, -1000);
+	renderer.vertex(-1000, 2000);
+	renderer.vertex(2000, 2000);
+	renderer.end();
+	renderer.popState();
 }
 
-void Component::drawName(bool showControl, bool showPC, double scale)
+void Component::drawName(Renderer& renderer, bool showControl, bool showPC, double scale)
 {
-	void *font = GLUT_BITMAP_HELVETICA_10;
-	if (scale > 1.8)
+	if(context->getDetailLevel() != DETAIL_FULL)
 	{
-		font = GLUT_BITMAP_HELVETICA_18;
-	}
-	else if (scale > 1.2)
-	{
-		font = GLUT_BITMAP_HELVETICA_12;
+		return;
 	}
-
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
+	renderer.pushState();
+	renderer.setColour(context->getColour(TEXT_COLOUR));
+	renderer.pushState();
 	// Translate text to the top of the component.
-	glColor4fv(colours[TEXT_COLOUR].c);
-	glTranslatef(textPos.x, textPos.y, 0.0);
-	glRasterPos2f(0, 0);
+	renderer.translate(textPos.x, textPos.y);
 	double rpy = 0;
-    for(uint i = 0; i < name.length(); i++)
-    {
-    	if(name[i] == '\n')
-    	{
-    		glRasterPos2f(0, (--rpy * 3) / getH());
-    	}
-    	else
-    	{
-			glutBitmapCharacter(font, name[i]);
-    	}
-	}
-	glPopMatrix();
+	wxString line;
+	for(uint i = 0; i < name.length(); i++)
+	{
+		if(name[i] == '\n')
+		{
+			renderer.drawText(0, (rpy * 3) / getH(), line, scale);
+			line.clear();
+			--rpy;
+		}
+		else
+		{
+			line += name[i];
+		}
+	}
+	renderer.drawText(0, (rpy * 3) / getH(), line, scale);
+	renderer.popState();
 	for(auto i = linkList.begin(); i != linkList.end(); ++i)
 	{
 		auto &currLink = i->second;
@@ -351,26 +380,20 @@ void Component::drawName(bool showControl, bool showPC, double scale)
 			{
 				if(showPC || !(currLink->getIsPC()))
 				{
-					glPushMatrix();
-					glTranslatef(currLink->getTextPos().x, currLink->getTextPos().y, 0.0);
-					glRasterPos2f(0, 0);
-					wxString linkName = currLink->getName();
-					for(uint j = 0; j < linkName.length(); ++j)
-					{
-						glutBitmapCharacter(font, linkName[j]);
-					}
-					glPopMatrix();
+					renderer.pushState();
+					renderer.translate(currLink->getTextPos().x, currLink->getTextPos().y);
+					renderer.drawText(0, 0, currLink->getName(), scale);
+					renderer.popState();
 				}
 			}
 		}
 	}
-	glPopAttrib();
+	renderer.popState();
 }
 
-void Component::drawConnections(bool showControl, bool showPC, Symbol* instr, bool simpleLayout)
+void Component::drawConnections(Renderer& renderer, bool showControl, bool showPC, Symbol* instr, bool simpleLayout)
 {
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
+	renderer.pushState();
 
 	for(auto i = linkList.begin(); i != linkList.end(); ++i)
 	{
@@ -403,11 +426,14 @@ void Component::drawConnections(bool showControl, bool showPC, Symbol* instr, bo
 							y1 = oLink->getAbsY();
 							x2 = iLink->getAbsX();
 							y2 = iLink->getAbsY();
-							glPushAttrib(GL_LINE_BIT);
-							glLineWidth(THIN_DATA_LINE_WIDTH);
+							renderer.pushState();
+							renderer.setLineWidth(THIN_DATA_LINE_WIDTH);
 							Component *inputComp = iLink->getComp();
 							Component* prevComp = oLink->getComp();
 							// Draw connection.
+							int currentInstruction = context->getCurrentInstruction();
+							bool highlightSingleInstruction = context->getHighlightSingleInstruction();
+							uint pipelineCycle = context->getPipelineCycle();
 							bool isCInstrValid = (0 <= currentInstruction && currentInstruction < 5);
 							if(oLink->isActive())
 							{
@@ -415,44 +441,44 @@ void Component::drawConnections(bool showControl, bool showPC, Symbol* instr, bo
 								if(oLink->isActiveValid(instr[pStage]) && (isCInstrValid && (int)pipelineStage <= currentInstruction || !highlightSingleInstruction || simpleLayout))
 								{
 									uint stage = (10 - pStage - pipelineCycle) % 5;
-									Color col = scaleColors(Color(0, 0, 0, 255), getActiveLinkColour(stage), oldActiveLinkColor);
-									glColor4fv(col.c);
+									Color col = scaleColors(Color(0, 0, 0, 255), context->getActiveLinkColour(stage), oldActiveLinkColor);
+									renderer.setColour(col);
 								}
 								else
 								{
-									glColor4fv(colours[LINK_COLOUR].c); //previously prevComp->linkColor.c
+									renderer.setColour(context->getColour(LINK_COLOUR)); //previously prevComp->linkColor.c
 								}
 							}
 							else
 							{
-								glColor4fv(colours[LINK_COLOUR].c);
+								renderer.setColour(context->getColour(LINK_COLOUR));
 							}
-							if((oLink->isActive() && (!highlightSingleInstruction || simpleLayout || (isCInstrValid && (int)pipelineStage <= currentInstruction))) || dataLinesBold)
+							if((oLink->isActive() && (!highlightSingleInstruction || simpleLayout || (isCInstrValid && (int)pipelineStage <= currentInstruction))) || context->getAreDataLinesBold())
 							{
 								if(!(inputComp->getIsControl() || prevComp->getIsControl()))
 								{
 									if(!(oLink->getIsControl()))
 									{
-										glLineWidth(DATA_LINE_WIDTH);
+										renderer.setLineWidth(DATA_LINE_WIDTH);
 									}
 								}							
 							}
 
-							glBegin(GL_LINE_STRIP);
+							renderer.begin(PRIMITIVE_LINE_STRIP);
 							if(showControl || !(inputComp->getIsControl()))
 							{
 								if(showPC || !(inputComp->getIsPC()))
 								{
-									glVertex2f(x1, y1);
+									renderer.vertex(x1, y1);
 									for(auto &&vertex : iLink->getVertices())
 									{
-										glVertex2f(vertex.x, vertex.y);
+										renderer.vertex(vertex.x, vertex.y);
 									}
-									glVertex2f(x2, y2);
+									renderer.vertex(x2, y2);
 								}
 							}
-							glEnd();
-							glPopAttrib();
+							renderer.end();
+							renderer.popState();
 						}
 					}
 				}
@@ -460,15 +486,20 @@ void Component::drawConnections(bool showControl, bool showPC, Symbol* instr, bo
 
 		}
 	}
-	glPopMatrix();
-	glPopAttrib();
+	renderer.popState();
 }
 
-void Component::drawConnectors(bool showControl, bool showPC, Symbol* instr, bool simpleLayout)
+void Component::drawConnectors(Renderer& renderer, bool showControl, bool showPC, Symbol* instr, bool simpleLayout)
 {
+	// Arrowheads are only a few pixels across when zoomed out. The
+	// connections end at the same points, so they are left to show the way.
+	if(context->getDetailLevel() == DETAIL_OUTLINE)
+	{
+		return;
+	}
 	bool large;
-	glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
-	glEnable(GL_POLYGON_SMOOTH);
+	renderer.pushState();
+	renderer.setPolygonSmooth(true);
 	for(auto i = linkList.begin(); i != linkList.end(); ++i)
 	{
 		large = false;
@@ -482,6 +513,9 @@ void Component::drawConnectors(bool showControl, bool showPC, Symbol* instr, boo
 				Component* inputComp = iLink->getComp();
 				if(inputComp->getType() != NODE_TYPE)
 				{
+					int currentInstruction = context->getCurrentInstruction();
+					bool highlightSingleInstruction = context->getHighlightSingleInstruction();
+					uint pipelineCycle = context->getPipelineCycle();
 					bool isCInstrValid = (0 <= currentInstruction && currentInstruction < 5);
 					if(oLink->isActive())
 					{
@@ -491,20 +525,20 @@ void Component::drawConnectors(bool showControl, bool showPC, Symbol* instr, boo
 						{
 							uint cStage = (10 - pStage - pipelineCycle) % 5;
 							float prop = prevComp->getOldActiveLinkColor();
-							Color col = scaleColors(Color(0, 0, 0, 255), getActiveLinkColour(cStage), prop);
-							glColor4fv(col.c);
+							Color col = scaleColors(Color(0, 0, 0, 255), context->getActiveLinkColour(cStage), prop);
+							renderer.setColour(col);
 						}
 						else
 						{
-							glColor4fv(colours[LINK_COLOUR].c);
+							renderer.setColour(context->getColour(LINK_COLOUR));
 						}
 					}
 					else
 					{
-						glColor4fv(colours[LINK_COLOUR].c);	
+						renderer.setColour(context->getColour(LINK_COLOUR));	
 					}
 					// Should this connection be large.
-					if((oLink->isActive() && (!highlightSingleInstruction || simpleLayout || (isCInstrValid && (int)(prevComp->getPipelineStage()) <= currentInstruction))) || dataLinesBold)
+					if((oLink->isActive() && (!highlightSingleInstruction || simpleLayout || (isCInstrValid && (int)(prevComp->getPipelineStage()) <= currentInstruction))) || context->getAreDataLinesBold())
 					{
 						if(!(inputComp->getIsControl() || prevComp->getIsControl()))
 						{
@@ -515,49 +549,49 @@ void Component::drawConnectors(bool showControl, bool showPC, Symbol* instr, boo
 						}	
 					}
 	
-					glPushMatrix();
+					renderer.pushState();
 					double x = iLink->getAbsX();
 					double y = iLink->getAbsY();
-					glTranslatef(x, y, 0);
+					renderer.translate(x, y);
 					if(showControl || !(oLink->getIsControl() || prevComp->getIsControl()))
 					{
 						if(showPC || !(oLink->getIsPC() || prevComp->getIsPC()))
 						{
-							drawLinkTriangle(iLink->getSide(), large);
+							drawLinkTriangle(renderer, iLink->getSide(), large);
 						}
 					}
-					glPopMatrix();
+					renderer.popState();
 				}
 			}
 		}
 	}
-	glPopAttrib();
+	renderer.popState();
 
 }
 
-void Component::drawLinkTriangle(Side edge, bool large)
+void Component::drawLinkTriangle(Renderer& renderer, Side edge, bool large)
 {
 	double height = large ? 1.0 : 0.5;
 	switch(edge)
 	{
 		case TOP:
-			glRotatef(270, 0, 0, 1);
+			renderer.rotate(270);
 			break;
 		case BOTTOM:
-			glRotatef(90, 0, 0, 1);
+			renderer.rotate(90);
 			break;
 		case LEFT:
 		// No rotation. Triangle already pointing in this direction.
 			break;
 		case RIGHT:
-			glRotatef(180, 0, 0, 1);
+			renderer.rotate(180);
 			break;
 	}
-	glBegin(GL_TRIANGLES);
-		glVertex2f(0, 0);
-		glVertex2f(-3, -height);
-		glVertex2f(-3, height);
-	glEnd();
+	renderer.begin(PRIMITIVE_TRIANGLES);
+		renderer.vertex(0, 0);
+		renderer.vertex(-3, -height);
+		renderer.vertex(-3, height);
+	renderer.end();
 }
 
 Link* Component::createInput(int slot, double x, double y, Side edge, wxString name, bool control, bool PC, bool showText, double textX, double textY, int startBit, int bitLength)
@@ -662,28 +696,39 @@ Link* Component::getLink(uint slot)
 	}
 }
 
-void Component::drawShadedRectangle()
+void Component::drawShadedRectangle(Renderer& renderer)
 {
-	glBegin(GL_TRIANGLE_STRIP);
-		glColor4fv(colours[FADE_COLOUR].c);
-		glVertex2f(0.0, 0.0);
-		glColor4fv(scaleColors(fillColorMin, colours[FADE_COLOUR], 0.5).c);
-		glVertex2f(1.0, 0.0);
-		glVertex2f(0.0, 1.0);
-		glColor4fv(fillColorMin.c);
-		glVertex2f(1.0, 1.0);
-	glEnd();
+	renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
+		renderer.setColour(context->getColour(FADE_COLOUR));
+		renderer.vertex(0.0, 0.0);
+		renderer.setColour(scaleColors(fillColorMin, context->getColour(FADE_COLOUR), 0.5));
+		renderer.vertex(1.0, 0.0);
+		renderer.vertex(0.0, 1.0);
+		renderer.setColour(fillColorMin);
+		renderer.vertex(1.0, 1.0);
+	renderer.end();
 }
 
-void Component::drawRectangle()
+void Component::drawRectangle(Renderer& renderer)
 {
-	glBegin(GL_LINE_LOOP);
-		glColor4fv(colours[BORDER_COLOUR].c);
-		glVertex2f(0.0, 0.0);
-		glVertex2f(1.0, 0.0);
-		glVertex2f(1.0, 1.0);
-		glVertex2f(0.0, 1.0);
-	glEnd();
+	renderer.begin(PRIMITIVE_LINE_LOOP);
+		renderer.setColour(context->getColour(BORDER_COLOUR));
+		renderer.vertex(0.0, 0.0);
+		renderer.vertex(1.0, 0.0);
+		renderer.vertex(1.0, 1.0);
+		renderer.vertex(0.0, 1.0);
+	renderer.end();
+}
+
+bool Component::drawOutline(Renderer& renderer)
+{
+	if(context->getDetailLevel() != DETAIL_OUTLINE)
+	{
+		return false;
+	}
+	drawShadedRectangle(renderer);
+	drawRectangle(renderer);
+	return true;
 }
 
 bool Component::allInputsActive()
@@ -703,6 +748,18 @@ bool Component::allInputsActive()
 	return true;
 }
 
+bool Component::allPortsActive()
+{
+	for(uint i = 0; i < numNetPorts; i++)
+	{
+		if(netPorts[i].input && !isPortActive(i))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 void Component::setLinkData(uint linkNum, luint value)
 {
 	if((luint)linkNum < linkList.size())
@@ -726,37 +783,6 @@ void Component::setLinkBits(uint linkNum, uint startBit, uint bitLength)
 		linkList[linkNum]->setBits(startBit, bitLength);
 	}
 }
-
-void Component::incrementPipelineCycle()
-{ 
-	pipelineCycle = (pipelineCycle + 4) % 5; 
-	// Increment current instruction for highlighting if it is already valid.
-	if(currentInstruction != -1)
-	{
-		currentInstruction++;
-	}
-	// If the current instruction goes outside the correct range, make it invalid.
-	if(currentInstruction > 4)
-	{
-		currentInstruction = -1;
-	}
-}
-
-void Component::setCurrentInstruction(int instr)
-{ 
-	// If instr is -1 it means no instruction should be highlighted therefore set
-	// currentInstruction to -1.
-	if(instr == -1)
-	{
-		currentInstruction = instr;
-	}
-	else
-	{
-		// To make sure the correct instruction is highlighted we have to 
-		// effectively increment the val inputted by pipelineCycle.
-		currentInstruction = (10 - instr - pipelineCycle) % 5; 
-	}
-}
 		
 MuxBase::MuxBase(double x, double y, double w, double h, wxString name, ComponentType type, bool PC)
 : Component(x, y, w, h, name, type, false, PC, 0.3, 0.75)
@@ -850,13 +876,8 @@ ShiftLeft2::ShiftLeft2(double x, double y, double w, double h, wxString name, bo
 	createOutput(1, 1, 0.5, RIGHT, _T("Output"));
 }
 
-luint Memory::getData(luint address)
-{ 
-	return data[address]; 
-}
-
 InstructionMemory::InstructionMemory(double x, double y, double w, double h, wxString name)
-: Memory(x, y, w, h, name, INSTRUCTION_MEMORY_TYPE, 0.3, 0.85)
+: Memory(x, y, w, h, name, INSTRUCTION_MEMORY_TYPE, Model::MAX_INSTRUCTIONS, 0.3, 0.85)
 {
 	createInput(0, 0, 0.5, LEFT, _T("Address"), false, false, true, 0.02, 0.48);
 	createOutput(1, 1, 0.5, RIGHT, _T("Instruction"), false, false, true, 0.55, 0.48);
@@ -864,7 +885,7 @@ InstructionMemory::InstructionMemory(double x, double y, double w, double h, wxS
 }
 
 Registers::Registers(Layout layout, double x, double y, double w, double h, wxString name)
-: Memory(x, y, w, h, name, REGISTERS_TYPE, 0.6, 0.48)
+: Memory(x, y, w, h, name, REGISTERS_TYPE, Model::MAX_REGISTERS, 0.6, 0.48)
 {
 	createInput(0, 0.5, 1.0, TOP, _T("RegWrite"));
 	createInput(1, 0, 0.8, LEFT, _T("Write Data"), false, false, true, 0.02, 0.78);
@@ -890,14 +911,50 @@ void Registers::reset()
 	data.clear();
 }
 
+void Registers::saveState(std::vector<luint>& state)
+{
+	Component::saveState(state);
+	state.push_back(writeToReg);
+}
+
+void Registers::loadState(const luint*& state)
+{
+	Component::loadState(state);
+	writeToReg = (int)*state++;
+}
+
 void DataMemory::reset()
 {
 	writeToMem = 0;
 	data.clear();
 }
 
+void DataMemory::saveState(std::vector<luint>& state)
+{
+	Component::saveState(state);
+	state.push_back(writeToMem);
+}
+
+void DataMemory::loadState(const luint*& state)
+{
+	Component::loadState(state);
+	writeToMem = (int)*state++;
+}
+
+void InstructionMemory::saveState(std::vector<luint>& state)
+{
+	Component::saveState(state);
+	state.push_back(outputAddress);
+}
+
+void InstructionMemory::loadState(const luint*& state)
+{
+	Component::loadState(state);
+	outputAddress = *state++;
+}
+
 DataMemory::DataMemory(Layout layout, double x, double y, double w, double h, wxString name)
-: Memory(x, y, w, h, name, DATA_MEMORY_TYPE, 0.35, 0.55)
+: Memory(x, y, w, h, name, DATA_MEMORY_TYPE, Model::MAX_DATA, 0.35, 0.55)
 {
 	createInput(0, 0.2, 1.0, TOP, _T("MemWrite"));
 	createInput(1, 0.8, 1.0, TOP, _T("MemRead"));
@@ -944,6 +1001,7 @@ PC::PC(int layout, double x, double y, double w, double h, wxString name)
 	createOutput(1, 1, 0.5, RIGHT, _T("Output"));
 	// Set initial program counter position to 0.
 	setLinkData(1, 0);
+	tempAddr = 0;
 	// Set delay (Point at which new instruction is read)
 	switch(layout)
 	{
@@ -973,6 +1031,28 @@ luint PC::getOutput()
 	return linkList[1]->getVal();
 }
 
+void PC::saveState(std::vector<luint>& state)
+{
+	Component::saveState(state);
+	state.push_back(delayRemaining);
+	state.push_back(tempAddr);
+}
+
+void PC::loadState(const luint*& state)
+{
+	Component::loadState(state);
+	delayRemaining = (uint)*state++;
+	tempAddr = *state++;
+}
+
+void PC::setAddress(luint address)
+{
+	// Restart the clock cycle from the given address.
+	setLinkData(1, address);
+	tempAddr = address;
+	delayRemaining = delay;
+}
+
 Node::Node(double x, double y, double w, double h, wxString name)
 : Component(x, y, w, h, name, NODE_TYPE)
 {
@@ -989,7 +1069,6 @@ Node::Node(double x, double y, double w, double h, wxString name)
 PipelineRegister::PipelineRegister(double x, double y, double w, double h, wxString name, ComponentType type, double textPosX, double textPosY)
 : Component(x, y, w, h, name, type, false, false, textPosX, textPosY)
 {
-	fillColorMin = colours[PIPEREG_COLOUR];
 	setDelay(Component::pipelineClockSteps); // Sets the wait time for all registers so that the relevant pipeline stage
 				// settles to the correct values before doing our propogation.
 	resetDelayRemaining();
@@ -1045,6 +1124,18 @@ void PipelineRegister::reset()
 	}
 }
 
+void PipelineRegister::saveState(std::vector<luint>& state)
+{
+	Component::saveState(state);
+	state.push_back(delayRemaining);
+}
+
+void PipelineRegister::loadState(const luint*& state)
+{
+	Component::loadState(state);
+	delayRemaining = (uint)*state++;
+}
+
 IFIDReg::IFIDReg(Layout layout, double x, double y, double w, double h, wxString name)
 : PipelineRegister(x, y, w, h, name, IFID_REG_TYPE, 0.04, 1.005)
 {
@@ -1198,218 +1289,229 @@ Forwarding::Forwarding(double x, double y, double w, double h, wxString name)
 	
 }
 
-void PC::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+void Forwarding::saveState(std::vector<luint>& state)
 {
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
-	position(); 
-	drawShadedRectangle();
-	drawRectangle();
-	drawName(showControl, showPC, scale);
-	glPopMatrix();
-	glPopAttrib();
+	Component::saveState(state);
+	state.push_back(delayRemaining);
 }
 
-void AndGate::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+void Forwarding::loadState(const luint*& state)
 {
-	glPushAttrib(GL_COLOR_BUFFER_BIT);	
-	glPushMatrix();
-	position(); 
-	drawShadedRectangle();
-	glScalef(0.67F, 1.0F, 1.0F);
+	Component::loadState(state);
+	delayRemaining = (uint)*state++;
+}
+
+void PC::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+{
+	renderer.pushState();
+	position(renderer);
+	drawShadedRectangle(renderer);
+	drawRectangle(renderer);
+	drawName(renderer, showControl, showPC, scale);
+	renderer.popState();
+}
+
+void AndGate::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+{
+	renderer.pushState();
+	position(renderer);
+	if(drawOutline(renderer))
+	{
+		renderer.popState();
+		return;
+	}
+	drawShadedRectangle(renderer);
+	renderer.scale(0.67F, 1.0F);
 	// Hide shaded areas outside shape.
-	glBegin(GL_TRIANGLE_STRIP);
-		glColor4fv(colours[BACKGROUND_COLOUR].c);
+	renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
+		renderer.setColour(context->getColour(BACKGROUND_COLOUR));
 		for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
 		{
 			if(i < NUM_CIRCLE_LINES / 2)
 			{
-				glVertex2f(1.5, 1);
+				renderer.vertex(1.5, 1);
 			}
 			else
 			{
-				glVertex2f(1.5, 0);
+				renderer.vertex(1.5, 0);
 			}
-			glVertex2f(1.0 + 0.5 * sin(PI * i / NUM_CIRCLE_LINES), 0.5 + 0.5 * cos(PI * i / NUM_CIRCLE_LINES));
+			renderer.vertex(1.0 + 0.5 * sin(PI * i / NUM_CIRCLE_LINES), 0.5 + 0.5 * cos(PI * i / NUM_CIRCLE_LINES));
 		}
-	glEnd();
+	renderer.end();
 	// Draw border.
-	glBegin(GL_LINE_LOOP);
-		glColor4fv(colours[BORDER_COLOUR].c);
-		glVertex2f(0.0, 0.0);
-		glVertex2f(0.0, 1.0);
-		glVertex2f(1.0, 1.0);
+	renderer.begin(PRIMITIVE_LINE_LOOP);
+		renderer.setColour(context->getColour(BORDER_COLOUR));
+		renderer.vertex(0.0, 0.0);
+		renderer.vertex(0.0, 1.0);
+		renderer.vertex(1.0, 1.0);
 		for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
 		{
-			glVertex2f(1.0 + 0.5 * sin(PI * i / NUM_CIRCLE_LINES), 0.5 + 0.5 * cos(PI * i / NUM_CIRCLE_LINES));
+			renderer.vertex(1.0 + 0.5 * sin(PI * i / NUM_CIRCLE_LINES), 0.5 + 0.5 * cos(PI * i / NUM_CIRCLE_LINES));
 		}
-		glVertex2f(1.0, 0.0);
-	glEnd();
-	drawName(showControl, showPC, scale);
-	glPopMatrix();
-	glPopAttrib();
-}
-
-void ALU::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
-{
-	glPushAttrib(GL_COLOR_BUFFER_BIT);	
-	glPushMatrix();
-	position(); 
-	glBegin(GL_TRIANGLE_STRIP);
-		glColor4fv(colours[FADE_COLOUR].c);
-  		glVertex2f(0.0F, 0.0F); 
-  		glColor4fv(scaleColors(fillColorMin, colours[FADE_COLOUR], 0.67).c);
-  		glVertex2f(0.0F, 0.33F);
-  		glColor4fv(scaleColors(fillColorMin, colours[FADE_COLOUR], 0.33).c);
-  		glVertex2f(1.0F, 0.33F);	
-  		glVertex2f(0.45F, 0.5F);
-  		glColor4fv(fillColorMin.c);
-  		glVertex2f(1.0F, 0.67F);
-  		glColor4fv(scaleColors(fillColorMin, colours[FADE_COLOUR], 0.33).c);
-  		glVertex2f(0.0F, 0.67F);
-  		glColor4fv(fillColorMin.c);
-  		glVertex2f(0.0F, 1.0F); 			
-  	glEnd();
-  	glBegin(GL_LINE_LOOP);
-		glColor4fv(colours[BORDER_COLOUR].c);
-  		glVertex2f(0.0F, 0.0F); 
-  		glVertex2f(1.0F, 0.33F);
-  		glVertex2f(1.0F, 0.67F);
-  		glVertex2f(0.0F, 1.0F);
-  		glVertex2f(0.0F, 0.67F);
-  		glVertex2f(0.45F, 0.5F);
-  		glVertex2f(0.0F, 0.33F);	
-	glEnd();
-  	drawName(showControl, showPC, scale);
-  	glPopMatrix();
-  	glPopAttrib();
-}
-
-void Memory::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
-{
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
-	position(); 
-	drawShadedRectangle();
-	drawRectangle();
-	drawName(showControl, showPC, scale);
-	glPopMatrix();
-	glPopAttrib();
-}
-
-void Control::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
-{
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
-	position(); 
-	glPushMatrix();
-	glTranslatef(0.5, 0.5, 0.0);
-	glScalef(0.5, 0.5, 1.0);
-	glBegin(GL_TRIANGLE_STRIP);
+		renderer.vertex(1.0, 0.0);
+	renderer.end();
+	drawName(renderer, showControl, showPC, scale);
+	renderer.popState();
+}
+
+void ALU::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+{
+	renderer.pushState();
+	position(renderer);
+	renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
+		renderer.setColour(context->getColour(FADE_COLOUR));
+  		renderer.vertex(0.0F, 0.0F); 
+  		renderer.setColour(scaleColors(fillColorMin, context->getColour(FADE_COLOUR), 0.67));
+  		renderer.vertex(0.0F, 0.33F);
+  		renderer.setColour(scaleColors(fillColorMin, context->getColour(FADE_COLOUR), 0.33));
+  		renderer.vertex(1.0F, 0.33F);	
+  		renderer.vertex(0.45F, 0.5F);
+  		renderer.setColour(fillColorMin);
+  		renderer.vertex(1.0F, 0.67F);
+  		renderer.setColour(scaleColors(fillColorMin, context->getColour(FADE_COLOUR), 0.33));
+  		renderer.vertex(0.0F, 0.67F);
+  		renderer.setColour(fillColorMin);
+  		renderer.vertex(0.0F, 1.0F); 			
+  	renderer.end();
+  	renderer.begin(PRIMITIVE_LINE_LOOP);
+		renderer.setColour(context->getColour(BORDER_COLOUR));
+  		renderer.vertex(0.0F, 0.0F); 
+  		renderer.vertex(1.0F, 0.33F);
+  		renderer.vertex(1.0F, 0.67F);
+  		renderer.vertex(0.0F, 1.0F);
+  		renderer.vertex(0.0F, 0.67F);
+  		renderer.vertex(0.45F, 0.5F);
+  		renderer.vertex(0.0F, 0.33F);	
+	renderer.end();
+  	drawName(renderer, showControl, showPC, scale);
+  	renderer.popState();
+}
+
+void Memory::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+{
+	renderer.pushState();
+	position(renderer);
+	drawShadedRectangle(renderer);
+	drawRectangle(renderer);
+	drawName(renderer, showControl, showPC, scale);
+	renderer.popState();
+}
+
+void Control::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+{
+	renderer.pushState();
+	position(renderer);
+	if(drawOutline(renderer))
+	{
+		renderer.popState();
+		return;
+	}
+	renderer.pushState();
+	renderer.translate(0.5, 0.5);
+	renderer.scale(0.5, 0.5);
+	renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
 		for(int i = 0; i <= NUM_CIRCLE_LINES / 2; i++)
 		{
 			double proportion = (cos((i * 2 * PI / NUM_CIRCLE_LINES) + (3 * PI / 4)) + 1) / 2;
-			glColor4fv(scaleColors(fillColorMin, colours[FADE_COLOUR], proportion).c);
-			glVertex2f(sin((2 * PI * i) / NUM_CIRCLE_LINES) , cos((2 * PI * i) / NUM_CIRCLE_LINES));
+			renderer.setColour(scaleColors(fillColorMin, context->getColour(FADE_COLOUR), proportion));
+			renderer.vertex(sin((2 * PI * i) / NUM_CIRCLE_LINES) , cos((2 * PI * i) / NUM_CIRCLE_LINES));
 			int j = NUM_CIRCLE_LINES - i;
 			proportion = (cos((j * 2 * PI / NUM_CIRCLE_LINES) + (3 * PI / 4)) + 1) / 2;
-			glColor4fv(scaleColors(fillColorMin, colours[FADE_COLOUR], proportion).c);
-			glVertex2f(sin((2 * PI * j) / NUM_CIRCLE_LINES) , cos((2 * PI * j) / NUM_CIRCLE_LINES));
+			renderer.setColour(scaleColors(fillColorMin, context->getColour(FADE_COLOUR), proportion));
+			renderer.vertex(sin((2 * PI * j) / NUM_CIRCLE_LINES) , cos((2 * PI * j) / NUM_CIRCLE_LINES));
 		
 		}
-	glEnd();
-	glBegin(GL_LINE_LOOP);
-		glColor4fv(colours[BORDER_COLOUR].c);
+	renderer.end();
+	renderer.begin(PRIMITIVE_LINE_LOOP);
+		renderer.setColour(context->getColour(BORDER_COLOUR));
 		for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
 		{
-			glVertex2f(sin((2 * PI * i) / NUM_CIRCLE_LINES) , cos((2 * PI * i) / NUM_CIRCLE_LINES));
+			renderer.vertex(sin((2 * PI * i) / NUM_CIRCLE_LINES) , cos((2 * PI * i) / NUM_CIRCLE_LINES));
 		}
-	glEnd();
-	glPopMatrix();
-	drawName(showControl, showPC, scale);
-	glPopMatrix();
-	glPopAttrib();
+	renderer.end();
+	renderer.popState();
+	drawName(renderer, showControl, showPC, scale);
+	renderer.popState();
 }
 
-void MuxBase::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+void MuxBase::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
 {
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
-	position(); 
+	renderer.pushState();
+	position(renderer);
+	if(drawOutline(renderer))
+	{
+		renderer.popState();
+		return;
+	}
 	// Fill rectangle with fade.
-	drawShadedRectangle();
+	drawShadedRectangle(renderer);
 	// Hide areas outside shape.
-	glBegin(GL_TRIANGLE_STRIP);
-		glColor4fv(colours[BACKGROUND_COLOUR].c);
+	renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
+		renderer.setColour(context->getColour(BACKGROUND_COLOUR));
 		for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
 		{
 			if(i < NUM_CIRCLE_LINES / 2)
 			{
-				glVertex2f(0, 0);
+				renderer.vertex(0, 0);
 			}
 			else
 			{
-				glVertex2f(1, 0);
+				renderer.vertex(1, 0);
 			}
-			glVertex2f(0.5 - 0.5 * cos(PI * i / NUM_CIRCLE_LINES), 0.125 - 0.125 * sin(PI * i / NUM_CIRCLE_LINES));
+			renderer.vertex(0.5 - 0.5 * cos(PI * i / NUM_CIRCLE_LINES), 0.125 - 0.125 * sin(PI * i / NUM_CIRCLE_LINES));
 		}
-	glEnd();
-	glBegin(GL_TRIANGLE_STRIP);
+	renderer.end();
+	renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
 		for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
 		{
 			if(i < NUM_CIRCLE_LINES / 2)
 			{
-				glVertex2f(1, 1);
+				renderer.vertex(1, 1);
 			}
 			else
 			{
-				glVertex2f(0, 1);
+				renderer.vertex(0, 1);
 			}
-			glVertex2f(0.5 + 0.5 * cos(PI * i / NUM_CIRCLE_LINES), 0.875 + 0.125 * sin(PI * i / NUM_CIRCLE_LINES));
+			renderer.vertex(0.5 + 0.5 * cos(PI * i / NUM_CIRCLE_LINES), 0.875 + 0.125 * sin(PI * i / NUM_CIRCLE_LINES));
 		}
-	glEnd();
+	renderer.end();
 	// Draw border.
-	glBegin(GL_LINE_LOOP);
-		glColor4fv(colours[BORDER_COLOUR].c);
+	renderer.begin(PRIMITIVE_LINE_LOOP);
+		renderer.setColour(context->getColour(BORDER_COLOUR));
 		for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
 		{
-			glVertex2f(0.5 - 0.5 * cos(PI * i / NUM_CIRCLE_LINES), 0.125 - 0.125 * sin(PI * i / NUM_CIRCLE_LINES));
+			renderer.vertex(0.5 - 0.5 * cos(PI * i / NUM_CIRCLE_LINES), 0.125 - 0.125 * sin(PI * i / NUM_CIRCLE_LINES));
 		}
 		for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
 		{
-			glVertex2f(0.5 + 0.5 * cos(PI * i / NUM_CIRCLE_LINES), 0.875 + 0.125 * sin(PI * i / NUM_CIRCLE_LINES));
+			renderer.vertex(0.5 + 0.5 * cos(PI * i / NUM_CIRCLE_LINES), 0.875 + 0.125 * sin(PI * i / NUM_CIRCLE_LINES));
 		}
-	glEnd();
-	drawName(showControl, showPC, scale);
-	glPopMatrix();
-	glPopAttrib();
+	renderer.end();
+	drawName(renderer, showControl, showPC, scale);
+	renderer.popState();
 }
 
-void PipelineRegister::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+void PipelineRegister::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
 {
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
-	position(); 
-	drawShadedRectangle();
-	drawRectangle();
-	drawName(showControl, showPC, scale);
-	glPopMatrix();
-	glPopAttrib();
+	renderer.pushState();
+	position(renderer);
+	drawShadedRectangle(renderer);
+	drawRectangle(renderer);
+	drawName(renderer, showControl, showPC, scale);
+	renderer.popState();
 }
 
-void Forwarding::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+void Forwarding::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
 {
-	glPushAttrib(GL_COLOR_BUFFER_BIT);
-	glPushMatrix();
-	position(); 
-	drawShadedRectangle();
-	drawRectangle();
-	drawName(showControl, showPC, scale);
-	glPopMatrix();
-	glPopAttrib();
+	renderer.pushState();
+	position(renderer);
+	drawShadedRectangle(renderer);
+	drawRectangle(renderer);
+	drawName(renderer, showControl, showPC, scale);
+	renderer.popState();
 }
 
-void Node::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
+void Node::draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale)
 {
 	uint numInputs = 1;
 	uint numOutputs = 2;
@@ -1466,9 +1568,11 @@ void Node::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLay
 	if(numInputs > 0 && numOutputs > 1)
 	{
 		double scaleFactor;
-		glPushAttrib(GL_COLOR_BUFFER_BIT);
-		glPushMatrix();
-		position();
+		renderer.pushState();
+		position(renderer);
+		int currentInstruction = context->getCurrentInstruction();
+		bool highlightSingleInstruction = context->getHighlightSingleInstruction();
+		uint pipelineCycle = context->getPipelineCycle();
 		bool isCInstrValid = (0 <= currentInstruction && currentInstruction < 5);
 		if(isActive())
 		{
@@ -1476,19 +1580,19 @@ void Node::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLay
 			if(isActiveValid(currInstr[pStage]) && (isCInstrValid && (int)pipelineStage <= currentInstruction || !highlightSingleInstruction || simpleLayout))
 			{
 				uint stage = (10 - pStage - pipelineCycle) % 5;
-				Color col = scaleColors(Color(0, 0, 0, 255), getActiveLinkColour(stage), oldActiveLinkColor);
-				glColor4fv(col.c);
+				Color col = scaleColors(Color(0, 0, 0, 255), context->getActiveLinkColour(stage), oldActiveLinkColor);
+				renderer.setColour(col);
 			}
 			else
 			{
-				glColor4fv(colours[LINK_COLOUR].c);
+				renderer.setColour(context->getColour(LINK_COLOUR));
 			}
 		}
 		else 
 		{
-			glColor4fv(colours[LINK_COLOUR].c);
+			renderer.setColour(context->getColour(LINK_COLOUR));
 		}
-		if((isActive() && (!highlightSingleInstruction || simpleLayout || (isCInstrValid && (int)pipelineStage <= currentInstruction))) || dataLinesBold)
+		if((isActive() && (!highlightSingleInstruction || simpleLayout || (isCInstrValid && (int)pipelineStage <= currentInstruction))) || context->getAreDataLinesBold())
 		{
 			scaleFactor = 1.3;
 		}
@@ -1496,15 +1600,26 @@ void Node::draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLay
 		{
 			scaleFactor = 1.0;
 		}
-		glScalef(0.5 * scaleFactor, 0.5 * scaleFactor, 1.0);
-		glBegin(GL_POLYGON);
-			for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
-			{
-				glVertex2f(sin((2 * PI * i) / NUM_CIRCLE_LINES) / 2, cos((2 * PI * i) / NUM_CIRCLE_LINES) / 2);
-			}
-		glEnd();
-		glPopMatrix();
-		glPopAttrib();
+		renderer.scale(0.5 * scaleFactor, 0.5 * scaleFactor);
+		if(context->getDetailLevel() == DETAIL_OUTLINE)
+		{
+			renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
+				renderer.vertex(-0.5, -0.5);
+				renderer.vertex(0.5, -0.5);
+				renderer.vertex(-0.5, 0.5);
+				renderer.vertex(0.5, 0.5);
+			renderer.end();
+		}
+		else
+		{
+			renderer.begin(PRIMITIVE_POLYGON);
+				for(int i = 0; i <= NUM_CIRCLE_LINES; i++)
+				{
+					renderer.vertex(sin((2 * PI * i) / NUM_CIRCLE_LINES) / 2, cos((2 * PI * i) / NUM_CIRCLE_LINES) / 2);
+				}
+			renderer.end();
+		}
+		renderer.popState();
 	}
 }
 
@@ -1642,6 +1757,16 @@ void Mux::step()
 	}
 }
 
+void Mux::evaluate()
+{
+	pullPort(0);
+	setPort(3, getPort(2) ? getPort(1) : getPort(0));
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 void Mux3::step()
 {
 	// Get control input.
@@ -1672,6 +1797,19 @@ void Mux3::step()
 	}
 }
 
+void Mux3::evaluate()
+{
+	uint control = getPort(3);
+	if(control < numNetPorts)
+	{
+		setPort(4, getPort(control));
+	}
+	if(!isActive() && isPortActive(0) && isPortActive(3))
+	{
+		this->setActive();
+	}
+}
+
 void ALU::step()
 {
 	luint result;
@@ -1725,6 +1863,46 @@ void ALU::step()
 	}
 }
 
+void ALU::evaluate()
+{
+	luint result;
+	luint input1 = getPort(0);
+	luint input2 = getPort(1);
+	long long int input1N, input2N;
+	bool neg1, neg2;
+	switch(getPort(2))
+	{
+		case 0: // And
+			result = input1 & input2;
+			break;
+		case 1: // Or
+			result = input1 | input2;
+			break;
+		case 2: // Add
+			result = (input1 +  input2) % ((luint)(1)<<32); 
+			break;
+		case 6: // Subtract
+			result = (input1 - input2) % ((luint)(1)<<32); 
+			break;
+		case 7: // Set on less than 
+			neg1 = !!(input1>>31);
+			neg2 = !!(input2>>31);
+			input1N = neg1 ? ((luint)(1)<<32) - input1 : input1;
+			input2N = neg2 ? ((luint)(1)<<32) - input2 : input2;
+			result = ((neg1 ? -input1N : input1N) < (neg2 ? -input2N : input2N)) ? 1 : 0;
+			break;
+		default:
+			result = getPort(3);
+			break;
+	}
+	setPort(3, result);
+	setPort(4, result == 0);
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 void MainControl::step()
 {
 	auto& result = lookup[linkList[MAINCONTROL_INPUT]->getVal()];
@@ -1743,6 +1921,24 @@ void MainControl::step()
 	}
 }
 
+void MainControl::evaluate()
+{
+	auto& result = lookup[getPort(MAINCONTROL_INPUT)];
+	
+	setPort(MAINCONTROL_REGDST, result->getRegDst());
+	setPort(MAINCONTROL_BRANCH, result->getBranch());
+	setPort(MAINCONTROL_MEMTOREG, result->getMemToReg());
+	setPort(MAINCONTROL_MEMREAD, result->getMemRead());
+	setPort(MAINCONTROL_ALUOP, result->getALUOp());
+	setPort(MAINCONTROL_MEMWRITE, result->getMemWrite());
+	setPort(MAINCONTROL_ALUSRC, result->getALUSrc());
+	setPort(MAINCONTROL_REGWRITE, result->getRegWrite());
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 void MainControlPipelined::step()
 {
 	auto& result = lookup[linkList[MAINCONTROLPIPELINED_INPUT]->getVal()];
@@ -1756,6 +1952,19 @@ void MainControlPipelined::step()
 	}
 }
 
+void MainControlPipelined::evaluate()
+{
+	auto& result = lookup[getPort(MAINCONTROLPIPELINED_INPUT)];
+
+	setPort(MAINCONTROLPIPELINED_WB, result->getWB());
+	setPort(MAINCONTROLPIPELINED_MEM, result->getMEM());
+	setPort(MAINCONTROLPIPELINED_EX, result->getEX());
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 void ALUControl::step()
 {
 	uint ALUOp = linkList[0]->getVal();
@@ -1794,6 +2003,41 @@ void ALUControl::step()
 	}
 }
 
+void ALUControl::evaluate()
+{
+	uint ALUOp = getPort(0);
+	uint function = getPort(1);
+	uint result;
+	try
+	{
+		switch(ALUOp)
+		{
+			case 0:
+				result = 2;
+				break;
+			case 1:
+				result = 6;
+				break;
+			case 2:
+				result = funcLookup[function];
+				break;
+			default:
+				throw InvalidInputEx;
+				break;
+		}
+	}
+	catch(std::exception& e)
+	{
+		std::cout << e.what() << this->getID() << std::endl;
+		result = 0;
+	}
+	setPort(2, result);
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 void DataMemory::step()
 {
 	luint memWrite = linkList[0]->getVal();
@@ -1804,11 +2048,11 @@ void DataMemory::step()
 	(++writeToMem) %= writeDelay;
 	if(memWrite && writeToMem >= writeWait)
 	{
-		data[address] = writeData;
+		data.set(address, writeData);
 	}
 	if(memRead)
 	{
-		luint readData = data[address];
+		luint readData = data.get(address);
 		linkList[4]->setVal(readData);
 	}
 	if(!isActive() && allInputsActive())
@@ -1817,6 +2061,24 @@ void DataMemory::step()
 	}	
 }
 
+void DataMemory::evaluate()
+{
+	luint address = getPort(2);
+	(++writeToMem) %= writeDelay;
+	if(getPort(0) && writeToMem >= writeWait)
+	{
+		data.set(address, getPort(3));
+	}
+	if(getPort(1))
+	{
+		setPort(4, data.get(address));
+	}
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}	
+}
+
 bool Registers::allInputsActive()
 {
 	if(!(linkList[0]->isActive()))
@@ -1846,8 +2108,8 @@ void Registers::step()
 	luint readReg1 = linkList[2]->getVal();
 	luint readReg2 = linkList[3]->getVal();
 	luint regWrite = linkList[0]->getVal();
-	luint readData1 = data[readReg1];
-	luint readData2 = data[readReg2];
+	luint readData1 = data.get(readReg1);
+	luint readData2 = data.get(readReg2);
 	//cout << readReg1 << endl;
 	//cout << readReg2 << endl;
 	// Set read data outputs.
@@ -1860,7 +2122,7 @@ void Registers::step()
 		luint writeReg = linkList[4]->getVal();
 		if(writeReg != 0)
 		{
-			data[writeReg] = writeData;
+			data.set(writeReg, writeData);
 		}
 	}
 	// Delay writing to register by one step to prevent junking good register data!
@@ -1875,16 +2137,49 @@ void Registers::step()
 	}
 }
 
+void Registers::evaluate()
+{
+	luint regWrite = getPort(0);
+	setPort(5, data.get(getPort(2)));
+	setPort(6, data.get(getPort(3)));
+	if(writeToReg >= 2)
+	{
+		luint writeReg = getPort(4);
+		if(writeReg != 0)
+		{
+			data.set(writeReg, getPort(1));
+		}
+	}
+	if(regWrite)
+	{
+		(++writeToReg) %= writeDelay;
+	}
+	if(!isActive() && isPortActive(2) && isPortActive(3))
+	{
+		this->setActive();
+	}
+}
+
 void InstructionMemory::step()
 {
 	outputAddress = linkList[0]->getVal();
-	linkList[1]->setVal(data[outputAddress]);
+	linkList[1]->setVal(data.get(outputAddress));
 	if(!isActive() && allInputsActive())
 	{
 		this->setActive();
 	}
 }
 
+void InstructionMemory::evaluate()
+{
+	outputAddress = getPort(0);
+	setPort(1, data.get(outputAddress));
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 void AndGate::step()
 {
 	luint input1 = linkList[0]->getVal();
@@ -1897,6 +2192,15 @@ void AndGate::step()
 	}
 }
 
+void AndGate::evaluate()
+{
+	setPort(2, getPort(0) & getPort(1));
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 luint AndGate::getOutput()
 { 
 	return linkList[2]->getVal(); 
@@ -1923,6 +2227,16 @@ void SignExtend::step()
 	}
 }
 
+void SignExtend::evaluate()
+{
+	luint input = getPort(0);
+	setPort(1, ((input>>15) % 2) ? ((((luint)(1)<<16)-1)<<16) + input : input);
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 void ShiftLeft2::step()
 {
 	luint input = linkList[0]->getVal();
@@ -1934,6 +2248,15 @@ void ShiftLeft2::step()
 	}
 }
 
+void ShiftLeft2::evaluate()
+{
+	setPort(1, (getPort(0)<<2) % ((luint)(1)<<32));
+	if(!isActive() && allPortsActive())
+	{
+		this->setActive();
+	}
+}
+
 void Forwarding::step()
 {
 	decrementDelayRemaining();
@@ -1987,6 +2310,37 @@ void Forwarding::step()
 	}
 }
 
+void Forwarding::evaluate()
+{
+	decrementDelayRemaining();
+			
+	luint readReg1 = getPort(FORWARDING_READREG1);
+	luint readReg2 = getPort(FORWARDING_READREG2);
+	luint exMemReg = getPort(FORWARDING_EXMEMREG);
+	luint memWBReg = getPort(FORWARDING_MEMWBREG);
+	int muxA = 0;
+	int muxB = 0;
+	if(readReg1 != 0)
+	{
+		muxA = (readReg1 == exMemReg) ? 2 : (readReg1 == memWBReg) ? 1 : 0;
+	}
+	if(readReg2 != 0)
+	{
+		muxB = (readReg2 == exMemReg) ? 2 : (readReg2 == memWBReg) ? 1 : 0;
+	}
+	setPort(FORWARDING_MUXA, muxA);
+	setPort(FORWARDING_MUXB, muxB);
+	if(getDelayRemaining() == 0)
+	{
+		resetDelayRemaining();	
+	}
+	// step() only checks the first read register.
+	if(!isActive() && isPortActive(FORWARDING_READREG1))
+	{
+		this->setActive();
+	}
+}
+
 void PC::step()
 {
 	delayRemaining--;
@@ -2008,6 +2362,27 @@ void PC::step()
 	}
 }
 
+void PC::evaluate()
+{
+	delayRemaining--;
+	if(delayRemaining == delay)
+	{
+		this->setActive();
+	}
+	if(delayRemaining == storeStep) 
+	{
+		tempAddr = getPort(0);
+	}
+	if(delayRemaining == updateStep)
+	{
+		setPort(1, tempAddr);
+	}
+	if(delayRemaining == 0)
+	{
+		delayRemaining = delay;
+	}
+}
+
 void IFIDReg::step()
 {
 	decrementDelayRemaining();
@@ -2022,6 +2397,20 @@ void IFIDReg::step()
 	}
 }
 
+void IFIDReg::evaluate()
+{
+	decrementDelayRemaining();
+	if(getDelayRemaining() == 1)
+	{
+		setPort(2, getPort(0));
+		setPort(3, getPort(1));
+	}
+	if(getDelayRemaining() == 0)
+	{
+		resetDelayRemaining();
+	}
+}
+
 void IDEXReg::step()
 {
 	decrementDelayRemaining();
@@ -2056,6 +2445,38 @@ void IDEXReg::step()
 	}
 }
 
+void IDEXReg::evaluate()
+{
+	decrementDelayRemaining();
+	if(getDelayRemaining() == 1)
+	{
+		int EX = getPort(6);
+		bool RegDst = !!(EX >> 3);
+		int ALUOp = (EX >> 1) - (RegDst << 2);
+		bool ALUSrc = !!(EX % 2);
+		
+		setPort(9, getPort(0));
+		setPort(10, getPort(1));
+		setPort(11, getPort(2));
+		setPort(12, getPort(3));
+		setPort(13, getPort(4));
+		setPort(14, getPort(5));
+		setPort(15, ALUSrc);
+		setPort(16, ALUOp);
+		setPort(17, RegDst);
+		setPort(18, getPort(7));
+		setPort(19, getPort(8));
+		if(layout == LAYOUT_FORWARDING)
+		{
+			setPort(21, getPort(20));
+		}
+	}
+	if(getDelayRemaining() == 0)
+	{
+		resetDelayRemaining();
+	}
+}
+
 void EXMEMReg::step()
 {
 	decrementDelayRemaining();
@@ -2082,6 +2503,32 @@ void EXMEMReg::step()
 	}
 }
 
+void EXMEMReg::evaluate()
+{
+	decrementDelayRemaining();
+	if(getDelayRemaining() == 1)
+	{
+		int MEM = getPort(5);
+		bool MemRead = !!(MEM >> 2);
+		bool MemWrite = !!((MEM >> 1) - (MemRead << 1));
+		bool Branch = !!(MEM % 2);
+		
+		setPort(7, getPort(0));
+		setPort(8, getPort(1));
+		setPort(9, getPort(2));
+		setPort(10, getPort(3));
+		setPort(11, getPort(4));
+		setPort(12, Branch);
+		setPort(13, MemWrite);
+		setPort(14, MemRead);
+		setPort(15, getPort(6));
+	}
+	if(getDelayRemaining() == 0)
+	{
+		resetDelayRemaining();
+	}
+}
+
 void MEMWBReg::step()
 {
 	decrementDelayRemaining();
@@ -2103,8 +2550,29 @@ void MEMWBReg::step()
 	}
 }
 
+void MEMWBReg::evaluate()
+{
+	decrementDelayRemaining();
+	if(getDelayRemaining() == 1)
+	{
+		int WB = getPort(3);
+		bool RegWrite = !!(WB >> 1);
+		bool MemToReg = !!(WB % 2);
+		
+		setPort(4, getPort(0));
+		setPort(5, getPort(1));
+		setPort(6, getPort(2));
+		setPort(7, MemToReg);
+		setPort(8, RegWrite);
+	}
+	if(getDelayRemaining() == 0)
+	{
+		resetDelayRemaining();
+	}
+}
+
 void Registers::maintainReg0()
 {
 	// Keep register 0 with the value 0;
-	data[0] = 0;
+	data.set(0, 0);
 }
@@ -23,9 +23,6 @@
 #ifndef COMPONENT_H_
 #define COMPONENT_H_
 
-#include <GL/glut.h>
-#include <wx/msw/winundef.h>
-
 #include <cmath>
 #include <string>
 #include <vector>
@@ -36,7 +33,6 @@
 #include <limits>
 #include <exception>
 
-#include <wx/wx.h>
 #include <wx/gdicmn.h>
 #include <wx/string.h>
 #include <wx/colour.h>
@@ -49,11 +45,51 @@
 #include "Color.h"
 #include "Coord.h"
 #include "Link.h"
+#include "Renderer.h"
+#include "Netlist.h"
+#include "MemoryStore.h"
 
 class Link;
 class InputLink;
 class OutputLink;
 
+// State shared by all the components of one Model: the pipeline tracking
+// used to colour links by stage, the display settings and the counters
+// for component and link IDs. Each Model has its own, so several models
+// can be built and run at once.
+class ComponentContext
+{
+	public:
+		ComponentContext();
+		void incrementPipelineCycle();
+		void resetPipelineCycle(){ pipelineCycle = 0; };
+		uint getPipelineCycle(){ return pipelineCycle; };
+		void setPipelineCycle(uint cycle){ pipelineCycle = cycle; };
+		void setCurrentInstruction(int instr);
+		int getCurrentInstruction(){ return currentInstruction; };
+		void setColour(configName name, wxColour colour);
+		Color getColour(configName name){ return colours[name]; };
+		wxColour getwxColour(configName name);
+		Color getActiveLinkColour(uint stage);
+		bool getAreDataLinesBold(){ return dataLinesBold; };
+		void setAreDataLinesBold(bool val = true){ dataLinesBold = val; };
+		bool getHighlightSingleInstruction(){ return highlightSingleInstruction; };
+		void setHighlightSingleInstruction(bool val = true){ highlightSingleInstruction = val; };
+		DetailLevel getDetailLevel(){ return detailLevel; };
+		void setDetailLevel(DetailLevel level){ detailLevel = level; };
+		int newComponentID(){ return componentCount++; };
+		int newLinkID(){ return linkCount++; };
+	private:
+		std::map<configName, Color> colours;
+		uint pipelineCycle; // What pipeline stage is the program in?
+		int currentInstruction;
+		bool dataLinesBold;
+		bool highlightSingleInstruction;
+		DetailLevel detailLevel;
+		int componentCount;
+		int linkCount;
+};
+
 enum ComponentType
 {
 	MUX_TYPE,
@@ -78,20 +114,24 @@ enum ComponentType
 
 class Component
 {
+	friend class Netlist;
 	public:
-		Component(){};
+		Component(){ context = 0; netValues = 0; netPorts = 0; numNetPorts = 0; dirty = true; };
 		Component(double x, double y, double w, double h, wxString name, ComponentType type, bool control = false, bool PC = false, double textPosX = 0, double textPosY = 1);
 		virtual ~Component(){};
 		virtual void reset(){};
-		virtual void resetColour(){ fillColorMin = colours[COMPONENT_COLOUR]; };
+		virtual void resetColour(){ fillColorMin = context->getColour(COMPONENT_COLOUR); };
+		// Attach the component to the context of its Model, numbering it and
+		// its links. Must be called before stepping or drawing.
+		void setContext(ComponentContext* context);
 		// Drawing functions:
-		static void drawBackground();
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale) = 0;
-		void drawName(bool showControl, bool showPC, double scale);
-		void drawConnections(bool showControl, bool showPC, Symbol* instr, bool simpleLayout);
-		virtual void drawConnectors(bool showControl, bool showPC, Symbol* instr, bool simpleLayout);
-		void drawLinkTriangle(Side edge, bool large);
-		void position();
+		static void drawBackground(Renderer& renderer, ComponentContext& context);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale) = 0;
+		void drawName(Renderer& renderer, bool showControl, bool showPC, double scale);
+		void drawConnections(Renderer& renderer, bool showControl, bool showPC, Symbol* instr, bool simpleLayout);
+		virtual void drawConnectors(Renderer& renderer, bool showControl, bool showPC, Symbol* instr, bool simpleLayout);
+		void drawLinkTriangle(Renderer& renderer, Side edge, bool large);
+		void position(Renderer& renderer);
 		// Setup functions:
 		Link* createInput(int slot, double x, double y, Side edge, wxString name = _T(""),  
 						  bool control = false, bool PC = false, bool showText = false, double textX = 0, double textY = 0,
@@ -104,6 +144,19 @@ class Component
 		virtual void preStep();
 		virtual void step(){};
 		virtual bool allInputsActive();
+		// Same as step() but reads and writes links through a compiled Netlist.
+		virtual void evaluate(){ step(); };
+		// Event driven stepping. An input marks its component dirty when its
+		// value changes. Combinational components have no state and use the
+		// plain allInputsActive() test, so they only need stepping when dirty.
+		virtual bool isCombinational(){ return false; };
+		bool isDirty(){ return dirty; };
+		void markDirty(){ dirty = true; };
+		void clearDirty(){ dirty = false; };
+		// Append the state changed by stepping to state, and read it back in
+		// the same order (used by Model::saveState()).
+		virtual void saveState(std::vector<luint>& state);
+		virtual void loadState(const luint*& state);
 		// Accessor functions:
 		int getX(){ return int(pos.x); };
 		int getY(){ return int(pos.y); };
@@ -139,36 +192,32 @@ class Component
 		virtual bool getIsPC(){ return PC; };
 		static const int simpleClockSteps = 7;
 		static const int pipelineClockSteps = 6;
-		static void setCurrentInstruction(int instr);
 		void setPipelineStage(uint stage){ pipelineStage = stage; };
 		uint getPipelineStage(){ return pipelineStage; };
-		static void incrementPipelineCycle();
-		static void resetPipelineCycle(){ pipelineCycle = 0; };
-		static void setActiveLinkColour(wxColour colour, uint stage);
-		static Color getActiveLinkColour(uint stage);
-		static void setColour(configName name, wxColour colour);
-		static Color getColour(configName name){ return colours[name]; };
-		static wxColour getwxColour(configName name);
 		float getOldActiveLinkColor(){ return oldActiveLinkColor; };
 		void resetOldActiveLinkColor(){ oldActiveLinkColor = 1.0; };
-		static bool getAreDataLinesBold(){ return dataLinesBold; };
-		static void setAreDataLinesBold(bool val = true){ dataLinesBold = val; };
-		static bool getHighlightSingleInstruction(){ return highlightSingleInstruction; };
-		static void setHighlightSingleInstruction(bool val = true){ highlightSingleInstruction = val; };
 	protected:
-		void drawShadedRectangle();
-		void drawRectangle();
-		static std::map<configName, Color> colours;
-		static std::vector<Color> activeLinkColors;
+		void drawShadedRectangle(Renderer& renderer);
+		void drawRectangle(Renderer& renderer);
+		// Draw a curved component as its shaded box when the detail level
+		// is DETAIL_OUTLINE. Returns true if it did.
+		bool drawOutline(Renderer& renderer);
+		static const std::vector<Color> activeLinkColors;
+		ComponentContext* context;
 		float oldActiveLinkColor;
 		Color fillColorMin;
 		static Color scaleColors(Color c1, Color c2, double proportion);
+		// Link access for evaluate(), slot numbers are the same as linkList.
+		luint getPort(uint slot){ const NetPort& port = netPorts[slot]; return (netValues[port.value] >> port.shift) & port.mask; };
+		void setPort(uint slot, luint val){ netValues[netPorts[slot].value] = val; };
+		void pullPort(uint slot){ const NetPort& port = netPorts[slot]; netValues[port.value] = netValues[port.driver]; };
+		bool isPortActive(uint slot){ const NetPort& port = netPorts[slot]; return port.source ? port.source->activeOutputs : (port.link != 0 && port.link->isActive()); };
+		bool allPortsActive();
 		std::map<int, std::unique_ptr<Link>> linkList;
+		luint* netValues;			// Value array of the netlist this component is compiled into.
+		const NetPort* netPorts;	// Ports of this component, indexed by link slot.
+		uint numNetPorts;
 		uint pipelineStage; // What pipiline stage is this component in?
-		static uint pipelineCycle; // What pipeline stage is the program in?
-		static bool dataLinesBold;
-		static int currentInstruction;
-		static bool highlightSingleInstruction;
 	private:
 		wxString getLinkInfo(int ID, Link* currLink);
 		void * getFont();
@@ -182,18 +231,18 @@ class Component
 		int ID;				// A unique ID for the component. Used for auto generation of code.
 		bool preActive;     // The component should be shown as activeOutputs next step.
 		bool activeOutputs; // The component has active outputs.
-		static int count;   // Count of the number of components created.
+		bool dirty;         // An input has changed since the last step.
 		bool control;		// Is this component a control type of component.
 		bool PC;			// Is this component involved in dealing with the PC.
-		static const GLfloat DATA_LINE_WIDTH;
-		static const GLfloat THIN_DATA_LINE_WIDTH;
+		static const float DATA_LINE_WIDTH;
+		static const float THIN_DATA_LINE_WIDTH;
 };
 
 class MuxBase: public Component
 {
 	public:
 		MuxBase(double x, double y, double w, double h, wxString name, ComponentType type, bool PC = false);
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
 	private:
 };
 
@@ -202,6 +251,7 @@ class Mux: public MuxBase
 	public:
 		Mux(double x, double y, double w = 5, double h = 15, wxString name = _T("Mux"), bool PC = false);
 		virtual void step();
+		virtual void evaluate();
 	private:
 };
 
@@ -211,6 +261,7 @@ class Mux3: public MuxBase
 		Mux3(double x, double y, double w = 5, double h = 15, wxString name = _T("Mux3"));
 	private:
 		virtual void step();
+		virtual void evaluate();
 };
 
 class Control: public Component
@@ -219,7 +270,7 @@ class Control: public Component
 		Control(double x, double y, double w, double h, wxString name, ComponentType type, bool control = true, bool PC = false, double textPosX = 0, double textPosY = 1)
 		: Component(x, y, w, h, name, type, control, PC, textPosX, textPosY){};
 	private:
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
 		
 };
 
@@ -259,6 +310,8 @@ class MainControl: public Control
 	public:
 		MainControl(int layout, double x, double y, double w = 10, double h = 15, wxString name = _T("Control"));
 		virtual void step();
+		virtual void evaluate();
+		virtual bool isCombinational(){ return true; };
 	private:
 		std::map<uint, std::unique_ptr<mainControlLookup>> lookup;
 		
@@ -269,6 +322,8 @@ class MainControlPipelined: public Control
 	public:
 		MainControlPipelined(int layout, double x, double y, double w = 10, double h = 15, wxString name = _T("Control"));
 		virtual void step();
+		virtual void evaluate();
+		virtual bool isCombinational(){ return true; };
 	private:
 		std::map<uint, std::unique_ptr<mainControlLookup>> lookup;
 };
@@ -278,6 +333,8 @@ class ALUControl: public Control
 	public:
 		ALUControl(double x, double y, double w = 10, double h = 15, wxString name = _T("ALU Control"));
 		virtual void step();
+		virtual void evaluate();
+		virtual bool isCombinational(){ return true; };
 	private:
 		std::map<uint, uint> funcLookup;
 };
@@ -287,6 +344,8 @@ class SignExtend: public Control
 	public:
 		SignExtend(double x, double y, double w = 10, double h = 15, wxString name = _T("Sign Extend"));
 		virtual void step();
+		virtual void evaluate();
+		virtual bool isCombinational(){ return true; };
 	private:
 };
 
@@ -295,19 +354,25 @@ class ShiftLeft2: public Control
 	public:
 		ShiftLeft2(double x, double y, double w = 10, double h = 15, wxString name = _T("Shift Left 2"), bool PC = false);
 		virtual void step();
+		virtual void evaluate();
+		virtual bool isCombinational(){ return true; };
 	private:
 };
 
 class Memory: public Component
 {
 	public:
-		Memory(double x, double y, double w, double h, wxString name, ComponentType type, double textPosX = 0, double textPosY = 1)
-		: Component(x, y, w, h, name, type, false, false, textPosX, textPosY){};
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
-		luint getData(luint address);
-		void setData(luint address, luint val){ data[address] = val; };
+		Memory(double x, double y, double w, double h, wxString name, ComponentType type, luint size, double textPosX = 0, double textPosY = 1)
+		: Component(x, y, w, h, name, type, false, false, textPosX, textPosY), data(size){};
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		luint getData(luint address){ return data.get(address); };
+		void setData(luint address, luint val){ data.set(address, val); markDirty(); };
+		const MemoryStore& getStore(){ return data; };
+		// Replace the whole contents, without journaling the changes.
+		void setStore(const MemoryStore& store){ data.assign(store); markDirty(); };
+		void setJournal(std::vector<MemoryWrite>* journal, uint id){ data.setJournal(journal, id); };
 	protected:
-		std::map<luint, luint> data;
+		MemoryStore data;
 	private:
 };
 
@@ -316,6 +381,10 @@ class InstructionMemory: public Memory
 	public:
 		InstructionMemory(double x, double y, double w = 25, double h = 25, wxString name = _T("Instruction Memory"));
 		virtual void step();
+		virtual void evaluate();
+		virtual bool isCombinational(){ return true; };
+		virtual void saveState(std::vector<luint>& state);
+		virtual void loadState(const luint*& state);
 		luint getOutputAddress(){ return outputAddress; };
 	private:
 		luint outputAddress;
@@ -326,8 +395,11 @@ class Registers: public Memory
 	public:
 		Registers(Layout layout, double x, double y, double w = 25, double h = 25, wxString name = _T("Registers"));
 		virtual void step();
+		virtual void evaluate();
 		virtual bool allInputsActive();
 		virtual void reset();
+		virtual void saveState(std::vector<luint>& state);
+		virtual void loadState(const luint*& state);
 	private:
 		int writeToReg;
 		void maintainReg0();
@@ -339,7 +411,10 @@ class DataMemory: public Memory
 	public:
 		DataMemory(Layout layout, double x, double y, double w = 25, double h = 25, wxString name = _T("Data Memory"));
 		virtual void step();
+		virtual void evaluate();
 		virtual void reset();
+		virtual void saveState(std::vector<luint>& state);
+		virtual void loadState(const luint*& state);
 	private:
 		int writeToMem;
 		int writeDelay;
@@ -350,8 +425,10 @@ class ALU: public Component
 {
 	public:
 		ALU(double x, double y, double w = 10, double h = 25, wxString name = _T("ALU"), bool PC = false);
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
 		virtual void step();
+		virtual void evaluate();
+		virtual bool isCombinational(){ return true; };
 	private:
 };
 
@@ -359,8 +436,10 @@ class AndGate: public Component
 {
 	public:
 		AndGate(double x, double y, double w = 8, double h = 5, wxString name = _T("AndGate"), bool PC = false);
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
 		virtual void step();
+		virtual void evaluate();
+		virtual bool isCombinational(){ return true; };
 		luint getOutput();
 	private:
 };
@@ -369,10 +448,16 @@ class PC: public Component
 {
 	public:
 		PC(int layout, double x, double y, double w = 5, double h = 8, wxString name = _T("PC"));
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
 		virtual void step();
+		virtual void evaluate();
 		virtual void reset();
+		virtual void saveState(std::vector<luint>& state);
+		virtual void loadState(const luint*& state);
 		luint getOutput();
+		void setAddress(luint address);
+		// True between clock cycles, when the output holds a newly fetched address.
+		bool atCycleStart(){ return delayRemaining == delay; };
 	private:	
 		uint delayRemaining;
 		uint delay;
@@ -385,9 +470,11 @@ class PipelineRegister: public Component
 {
 	public:
 		PipelineRegister(double x, double y, double w, double h, wxString name, ComponentType type, double textPosX = 0.0, double textPosY = 1.0);
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
 		virtual void reset();
-		virtual void resetColour(){ fillColorMin = colours[PIPEREG_COLOUR]; };
+		virtual void saveState(std::vector<luint>& state);
+		virtual void loadState(const luint*& state);
+		virtual void resetColour(){ fillColorMin = context->getColour(PIPEREG_COLOUR); };
 		wxString getMainInfo(wxPoint mousePos);
 	protected:
 		void setDelay(int delay){ this->delay = delay; };
@@ -405,6 +492,7 @@ class IFIDReg: public PipelineRegister
 		IFIDReg(Layout layout, double x, double y, double w = 4, double h = 120, wxString name = _T("IF/ID"));
 	private:
 		virtual void step();
+		virtual void evaluate();
 };
 
 class IDEXReg: public PipelineRegister
@@ -413,6 +501,7 @@ class IDEXReg: public PipelineRegister
 		IDEXReg(Layout layout, double x, double y, double w = 4, double h = 120, wxString name = _T("ID/EX"));
 	private:
 		virtual void step();
+		virtual void evaluate();
 		Layout layout;
 };
 
@@ -422,6 +511,7 @@ class EXMEMReg: public PipelineRegister
 		EXMEMReg(Layout layout, double x, double y, double w = 4, double h = 120, wxString name = _T("EX/MEM"));
 	private:
 		virtual void step();
+		virtual void evaluate();
 };
 
 class MEMWBReg: public PipelineRegister
@@ -430,13 +520,16 @@ class MEMWBReg: public PipelineRegister
 		MEMWBReg(Layout layout, double x, double y, double w = 4, double h = 120, wxString name = _T("MEM/WB"));
 	private:
 		virtual void step();
+		virtual void evaluate();
 };
 
 class Forwarding: public Component
 {
 	public:
 		Forwarding(double x, double y, double w = 30, double h = 10, wxString name = _T("Forwarding"));
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		virtual void saveState(std::vector<luint>& state);
+		virtual void loadState(const luint*& state);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
 	private:
 		void setDelay(int delay){ this->delay = delay; };
 		void decrementDelayRemaining(){ delayRemaining--; };
@@ -445,13 +538,14 @@ class Forwarding: public Component
 		uint delay;
 		uint delayRemaining;
 		virtual void step();
+		virtual void evaluate();
 };
 
 class Node: public Component
 {
 	public:
 		Node(double x, double y, double w = 2, double h = 2, wxString name = _T(""));
-		virtual void draw(bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
+		virtual void draw(Renderer& renderer, bool showControl, bool showPC, Symbol* currInstr, bool simpleLayout, double scale);
 		virtual void drawConnectors(bool showControl, bool showPC){};
 		virtual bool isActive();
 		virtual luint getVal();
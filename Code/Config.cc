@@ -68,6 +68,7 @@ Config::Config()
 	names[SHOW_POPUPS] = "showpopups";
 	names[HIGHLIGHT_SINGLE_INSTRUCTION] = "highlightsingleinstruction";
 	names[SHOW_BOLD_DATA_LINES] = "showbolddatalines";
+	names[SHOW_TIMINGS] = "showtimings";
 	names[SHOW_FORMAT_BIN] = "binaryformat";
 	names[SHOW_FORMAT_DEC] = "decimalformat";
 	names[SHOW_FORMAT_HEX] = "hexadecimalformat";
@@ -120,6 +121,7 @@ void Config::setDefaults()
 	setBool(SHOW_POPUPS, true);
 	setBool(HIGHLIGHT_SINGLE_INSTRUCTION, true);
 	setBool(SHOW_BOLD_DATA_LINES, true);
+	setBool(SHOW_TIMINGS, false);
 	setBool(SHOW_FORMAT_BIN, false);
 	setBool(SHOW_FORMAT_DEC, true);
 	setBool(SHOW_FORMAT_HEX, false);
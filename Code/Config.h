@@ -56,6 +56,7 @@ enum configName
 	SHOW_POPUPS,
 	HIGHLIGHT_SINGLE_INSTRUCTION,
 	SHOW_BOLD_DATA_LINES,	
+	SHOW_TIMINGS,
 	SHOW_FORMAT_BIN,
 	SHOW_FORMAT_DEC,
 	SHOW_FORMAT_HEX,
@@ -0,0 +1,323 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <cstdio>
+#include <iostream>
+
+#include <wx/app.h>
+#include <wx/init.h>
+#include <wx/image.h>
+#include <wx/filename.h>
+#ifdef __WXMSW__
+#include <wx/msw/wrapwin.h>
+#endif
+
+#include "BatchRunner.h"
+#include "FrameExporter.h"
+#include "Model.h"
+#include "FormatBenchmark.h"
+#include "SelfTest.h"
+
+#include "Console.h"
+
+Console::Console(const std::vector<wxString>& args)
+	: args(args)
+{
+	result = 0;
+}
+
+int Console::run()
+{
+	attachParentConsole();
+	wxString mode = args.empty() ? wxString(_T("")) : args[0];
+	if(mode == _T("--batch"))
+	{
+		runBatch();
+	}
+	else if(mode == _T("--export"))
+	{
+		runExport();
+	}
+	else if(mode == _T("--image"))
+	{
+		runImage();
+	}
+	else if(mode == _T("--benchmark-format"))
+	{
+		runFormatBenchmark();
+	}
+	else if(mode == _T("--self-test"))
+	{
+		runSelfTest();
+	}
+	else
+	{
+		result = 1;
+	}
+	return result;
+}
+
+bool Console::isConsoleMode(wxString arg)
+{
+	return arg == _T("--batch") || arg == _T("--export") || arg == _T("--image")
+		|| arg == _T("--benchmark-format") || arg == _T("--self-test");
+}
+
+int Console::main(int argc, char** argv)
+{
+	// Set up a console app before wx creates the GUI one, which would need
+	// a display.
+	wxAppConsole::SetInstance(new wxAppConsole);
+	wxInitializer initializer(argc, argv);
+	if(!initializer.IsOk())
+	{
+		std::cerr << "Could not initialise wxWidgets\n";
+		return 1;
+	}
+	wxInitAllImageHandlers();
+	std::vector<wxString> args;
+	for(int i = 1; i < argc; i++)
+	{
+		args.push_back(wxString(argv[i], wxConvLocal));
+	}
+	Console console(args);
+	return console.run();
+}
+
+void Console::attachParentConsole()
+{
+#ifdef __WXMSW__
+	// The program is built for the GUI subsystem, so it starts without a
+	// console even from a command prompt. Write to the prompt's console.
+	if(AttachConsole(ATTACH_PARENT_PROCESS))
+	{
+		std::freopen("CONOUT$", "w", stdout);
+		std::freopen("CONOUT$", "w", stderr);
+		std::cout.clear();
+		std::cerr.clear();
+	}
+#endif
+}
+
+// Usage: --batch [--layout simple|pipeline|forwarding] [--cycles n] [--threads n] file.def...
+// Runs each program without opening a window and writes the final state of
+// each to standard output.
+void Console::runBatch()
+{
+	Layout layout = LAYOUT_SIMPLE;
+	unsigned long maxCycles = BatchRunner::DEFAULT_MAX_CYCLES;
+	unsigned long numThreads = 0;
+	std::vector<wxString> files;
+	for(size_t i = 1; i < args.size(); i++)
+	{
+		wxString arg = args[i];
+		if(arg == _T("--layout") && i + 1 < args.size())
+		{
+			parseLayout(args[++i], layout);
+		}
+		else if(arg == _T("--cycles") && i + 1 < args.size())
+		{
+			args[++i].ToULong(&maxCycles);
+		}
+		else if(arg == _T("--threads") && i + 1 < args.size())
+		{
+			args[++i].ToULong(&numThreads);
+		}
+		else
+		{
+			files.push_back(arg);
+		}
+	}
+	BatchRunner runner(layout, maxCycles, numThreads);
+	for(auto&& i : files)
+	{
+		runner.addFile(i);
+	}
+	runner.run();
+	runner.writeReport(std::cout);
+	for(auto&& i : runner.getResults())
+	{
+		if(!i.valid)
+		{
+			result = 1;
+		}
+	}
+}
+
+// Usage: --export [--layout simple|pipeline|forwarding] [--cycles n] [--threads n]
+//                 [--scale pixels] [--svg] [--no-png] [--output dir] file.def...
+// Writes the datapath after every step of each program to <name>_<cycle>.png
+// (and .svg), next to the program or in the output directory.
+void Console::runExport()
+{
+	Layout layout = LAYOUT_SIMPLE;
+	unsigned long maxCycles = FrameExporter::DEFAULT_MAX_CYCLES;
+	unsigned long numThreads = 0;
+	double scale = FrameExporter::DEFAULT_SCALE;
+	bool png = true;
+	bool svg = false;
+	wxString output;
+	std::vector<wxString> files;
+	for(size_t i = 1; i < args.size(); i++)
+	{
+		wxString arg = args[i];
+		if(arg == _T("--layout") && i + 1 < args.size())
+		{
+			parseLayout(args[++i], layout);
+		}
+		else if(arg == _T("--cycles") && i + 1 < args.size())
+		{
+			args[++i].ToULong(&maxCycles);
+		}
+		else if(arg == _T("--threads") && i + 1 < args.size())
+		{
+			args[++i].ToULong(&numThreads);
+		}
+		else if(arg == _T("--scale") && i + 1 < args.size())
+		{
+			args[++i].ToDouble(&scale);
+		}
+		else if(arg == _T("--svg"))
+		{
+			svg = true;
+		}
+		else if(arg == _T("--no-png"))
+		{
+			png = false;
+		}
+		else if(arg == _T("--output") && i + 1 < args.size())
+		{
+			output = args[++i];
+		}
+		else
+		{
+			files.push_back(arg);
+		}
+	}
+	FrameExporter exporter(layout, maxCycles, numThreads);
+	exporter.setScale(scale);
+	exporter.setWritePNG(png);
+	exporter.setWriteSVG(svg);
+	for(auto&& i : files)
+	{
+		wxFileName name(i);
+		if(output != _T(""))
+		{
+			name.AssignDir(output);
+			name.SetName(wxFileName(i).GetName());
+		}
+		name.ClearExt();
+		luint frames = exporter.exportProgram(i, name.GetFullPath());
+		std::cout << (const char*)i.mb_str() << ": ";
+		if(frames == 0)
+		{
+			std::cout << "parse errors\n";
+			result = 1;
+		}
+		else
+		{
+			std::cout << frames << " frames\n";
+		}
+	}
+}
+
+// Usage: --image file.def...
+// Assembles each program and saves it as file.mipsimg, which loads without
+// being parsed again.
+void Console::runImage()
+{
+	for(size_t i = 1; i < args.size(); i++)
+	{
+		wxFileName name(args[i]);
+		name.SetExt(_T("mipsimg"));
+		Model processor;
+		processor.resetup();
+		std::cout << (const char*)name.GetFullPath().mb_str() << ": ";
+		if(!processor.loadFile(args[i]))
+		{
+			std::cout << "could not read " << (const char*)args[i].mb_str() << "\n";
+			result = 1;
+			continue;
+		}
+		processor.parse(_T(""));
+		if(processor.getNumberOfErrors() != 0)
+		{
+			// A program with errors is not worth an image.
+			std::cout << processor.getNumberOfErrors() << " parse errors\n";
+			result = 1;
+		}
+		else if(!processor.saveFile(name.GetFullPath()))
+		{
+			std::cout << "could not be written\n";
+			result = 1;
+		}
+		else
+		{
+			std::cout << "saved\n";
+		}
+	}
+}
+
+// Usage: --benchmark-format [--iterations n]
+// Times the number formatting used by the memory lists and link popups.
+void Console::runFormatBenchmark()
+{
+	unsigned long iterations = FormatBenchmark::DEFAULT_ITERATIONS;
+	for(size_t i = 1; i < args.size(); i++)
+	{
+		if(args[i] == _T("--iterations") && i + 1 < args.size())
+		{
+			args[++i].ToULong(&iterations);
+		}
+	}
+	FormatBenchmark benchmark(iterations);
+	if(!benchmark.run(std::cout))
+	{
+		result = 1;
+	}
+}
+
+// Usage: --self-test
+void Console::runSelfTest()
+{
+	SelfTest test;
+	if(!test.run(std::cout))
+	{
+		result = 1;
+	}
+}
+
+void Console::parseLayout(wxString name, Layout& layout)
+{
+	if(name == _T("simple"))
+	{
+		layout = LAYOUT_SIMPLE;
+	}
+	else if(name == _T("pipeline"))
+	{
+		layout = LAYOUT_PIPELINE;
+	}
+	else if(name == _T("forwarding"))
+	{
+		layout = LAYOUT_FORWARDING;
+	}
+}
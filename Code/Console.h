@@ -0,0 +1,59 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include <vector>
+
+#include <wx/string.h>
+
+#include "Enums.h"
+
+// The modes that run without a window: --batch, --export, --image,
+// --benchmark-format and --self-test. They only use the base library and
+// wxImage, so they run where there is no display.
+class Console
+{
+	public:
+		// args[0] is the mode, the rest are its options and files.
+		Console(const std::vector<wxString>& args);
+		// Run the mode. Returns the exit code.
+		int run();
+		static bool isConsoleMode(wxString arg);
+		// Entry point for the console modes, used instead of the GUI app.
+		static int main(int argc, char** argv);
+	private:
+		// On Windows, send the output to the console the program was
+		// started from.
+		static void attachParentConsole();
+		void runBatch();
+		void runExport();
+		void runImage();
+		void runFormatBenchmark();
+		void runSelfTest();
+		static void parseLayout(wxString name, Layout& layout);
+		std::vector<wxString> args;
+		int result;
+};
+
+#endif /*CONSOLE_H_*/
@@ -20,7 +20,11 @@
  * 
  */
  
+#include <algorithm>
+
 #include "Datalist.h"
+#include "Model.h"
+#include "Maths.h"
 
 BEGIN_EVENT_TABLE(Datalist, wxListCtrl)
     EVT_LIST_COL_BEGIN_DRAG(ID_INSTRUCTION_LIST, Datalist::OnDataListColSizeAdjusted)
@@ -29,9 +33,11 @@ BEGIN_EVENT_TABLE(Datalist, wxListCtrl)
     EVT_LIST_ITEM_SELECTED(ID_INSTRUCTION_LIST, Datalist::OnSelect)
 END_EVENT_TABLE()
 
-Datalist::Datalist(uint multiplier, uint maxVals, wxString firstColTitle, wxWindow* parent, wxWindowID id)
-: wxListCtrl(parent, id, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_SINGLE_SEL)
+Datalist::Datalist(Model* processor, uint memory, uint multiplier, uint maxVals, wxString firstColTitle, wxWindow* parent, wxWindowID id)
+: wxListCtrl(parent, id, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_VIRTUAL)
 {
+	this->processor = processor;
+	this->memory = memory;
 	this->multiplier = multiplier;
 	this->maxVals = maxVals;
 	this->firstColTitle = firstColTitle;
@@ -43,6 +49,84 @@ void Datalist::InsertFirstColumn()
 	this->InsertColumn(0, firstColTitle);
 }
 
+void Datalist::resetItems()
+{
+	SetItemCount(maxVals);
+	shownValues.assign(maxVals, 0);
+	for(uint i = 0; i < maxVals; i++)
+	{
+		shownValues[i] = processor->getMemoryData(memory, i * multiplier);
+	}
+	if(isSelectedIndexValid())
+	{
+		SetItemState(selectedIndex / multiplier, wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED);
+	}
+	RefreshItems(0, maxVals - 1);
+}
+
+void Datalist::refreshChanged()
+{
+	long first = maxVals;
+	long last = -1;
+	for(uint i = 0; i < shownValues.size(); i++)
+	{
+		luint val = processor->getMemoryData(memory, i * multiplier);
+		if(val != shownValues[i])
+		{
+			shownValues[i] = val;
+			first = std::min(first, (long)i);
+			last = i;
+		}
+	}
+	if(last >= first)
+	{
+		RefreshItems(first, last);
+	}
+}
+
+void Datalist::refreshWrites(const std::vector<MemoryWrite>& writes)
+{
+	for(auto&& write : writes)
+	{
+		if(write.memory == memory && write.address % multiplier == 0 && write.address / multiplier < shownValues.size())
+		{
+			long row = write.address / multiplier;
+			shownValues[row] = write.newValue;
+			RefreshItem(row);
+		}
+	}
+}
+
+wxString Datalist::OnGetItemText(long item, long column) const
+{
+	luint address = item * multiplier;
+	if(column == 0)
+	{
+		return wxString::Format(_T("%d"), (int)address);
+	}
+	wxString val;
+	if(memory == ID_INSTRUCTION_LIST && processor->getBool(SHOW_INSTRUCTION_FIELDS))
+	{
+		processor->getFieldedInstruction(address, val);
+	}
+	else
+	{
+		val = Maths::convertToBase(processor->getMemoryData(memory, address), memory == ID_INSTRUCTION_LIST);
+	}
+	return val;
+}
+
+wxListItemAttr* Datalist::OnGetItemAttr(long item) const
+{
+	if(memory != ID_INSTRUCTION_LIST)
+	{
+		return NULL;
+	}
+	// Current instructions are coloured by pipeline stage.
+	itemAttr.SetBackgroundColour(processor->getColourForInstruction(item * multiplier));
+	return &itemAttr;
+}
+
 void Datalist::OnDataListColSizeAdjusted(wxListEvent& event)
 {
 	// Prevent adjusting column sizes on these lists.
@@ -24,24 +24,44 @@
 #define DATALIST_H_
 
 #include <iostream>
+#include <vector>
 #include <wx/wx.h>
 #include <wx/listctrl.h>
 
 #include "Types.h"
 #include "Enums.h"
+#include "MemoryStore.h"
 
+class Model;
+
+// Virtual list of one of the model's memories. Rows are formatted from the
+// model only when they are drawn, so only the visible ones cost anything.
 class Datalist : public wxListCtrl
 {
 	public:
-		Datalist(uint multiplier, uint maxVals, wxString firstColTitle, wxWindow* parent, wxWindowID id);
+		Datalist(Model* processor, uint memory, uint multiplier, uint maxVals, wxString firstColTitle, wxWindow* parent, wxWindowID id);
 		void InsertFirstColumn();
+		// Redraw every row, after the format or the program has changed.
+		void resetItems();
+		// Redraw only the rows whose value changed since the last call, as a
+		// single range. Row colours are refreshed by the frame.
+		void refreshChanged();
+		// Redraw only the rows of this memory in writes, as journaled by
+		// the model's latest step.
+		void refreshWrites(const std::vector<MemoryWrite>& writes);
 		uint getMultiplier(){ return multiplier; };
 		uint getMaxVals(){ return maxVals; };
 		long getSelectedIndex(){ return (selectedIndex < 0) ? 0 : selectedIndex; };
 		bool isSelectedIndexValid(){ return (selectedIndex < 0) ? false : true;  };
 	private:
+		virtual wxString OnGetItemText(long item, long column) const;
+		virtual wxListItemAttr* OnGetItemAttr(long item) const;
 		void OnDataListColSizeAdjusted(wxListEvent& event);
 		void OnSelect(wxListEvent& event);
+		Model* processor;
+		uint memory;
+		std::vector<luint> shownValues;		// As last refreshed.
+		mutable wxListItemAttr itemAttr;
 		uint multiplier;
 		uint maxVals;
 		wxString firstColTitle;
@@ -87,6 +87,7 @@ Dialog::Dialog(wxWindow* parent, wxWindowID id, wxIconBundle *ico, Model *proc,
 	checkBoxes[SHOW_POPUPS] = new wxCheckBox(this, wxID_ANY, _T("Show pop-ups"));
 	checkBoxes[HIGHLIGHT_SINGLE_INSTRUCTION] = new wxCheckBox(this, wxID_ANY, _T("Highlight single instruction on pipelined layouts"));
 	checkBoxes[SHOW_BOLD_DATA_LINES] = new wxCheckBox(this, wxID_ANY, _T("Show bold data lines at all times"));
+	checkBoxes[SHOW_TIMINGS] = new wxCheckBox(this, wxID_ANY, _T("Show step and redraw timings"));
 	
 	Config& c = Config::Instance();
 	// Get default values for all the checkboxes & add then to the dialog.
@@ -58,6 +58,22 @@ enum Layout
 	LAYOUT_MAX = 2
 };
 
+enum SimulationMode
+{
+	SIM_INTERPRETED,	// Step every component through its link maps.
+	SIM_COMPILED,		// Step the flattened Netlist built by Model::setup().
+	SIM_EVENT_DRIVEN	// As interpreted, but only step combinational components whose inputs changed.
+};
+
+// How much of the datapath is drawn, chosen from the zoom so the overview
+// stays cheap to draw.
+enum DetailLevel
+{
+	DETAIL_FULL,		// Everything.
+	DETAIL_NO_TEXT,		// Labels would be too small to read, leave them out.
+	DETAIL_OUTLINE		// Also draw curved shapes as boxes and leave out connector arrowheads.
+};
+
 enum MainControlInputOutputs
 {
 	MAINCONTROL_MIN = 0,
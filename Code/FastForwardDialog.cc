@@ -0,0 +1,98 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <wx/stattext.h>
+#include <wx/msgdlg.h>
+
+#include "Model.h"
+
+#include "FastForwardDialog.h"
+
+BEGIN_EVENT_TABLE(FastForwardDialog, wxDialog)
+    EVT_BUTTON(wxID_OK, FastForwardDialog::OnOK)
+END_EVENT_TABLE()
+
+FastForwardDialog::FastForwardDialog(wxWindow* parent, wxIconBundle *ico)
+	:wxDialog(parent, wxID_ANY, _T("Fast Forward"))
+{
+	SetIcons(*ico);
+	wxSizer *mainSizer = new wxBoxSizer(wxVERTICAL);
+	SetSizer(mainSizer);
+	mainSizer->Add(new wxStaticText(this, wxID_ANY, _T("Run the program from the start without drawing the datapath.")), 0, wxEXPAND | wxALL, 6);
+
+	wxFlexGridSizer *fieldSizer = new wxFlexGridSizer(2, 2, 3, 3);
+	fieldSizer->AddGrowableCol(1);
+	count = new wxSpinCtrl(this, wxID_ANY, _T("100"), wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 1000000, 100);
+	stopAddress = new wxTextCtrl(this, wxID_ANY, _T(""));
+	stopAddress->SetToolTip(_T("Leave empty to run every instruction. Use 0x for a hexadecimal address."));
+	fieldSizer->Add(new wxStaticText(this, wxID_ANY, _T("&Instructions:")), 0, wxALIGN_CENTER_VERTICAL);
+	fieldSizer->Add(count, 0, wxEXPAND);
+	fieldSizer->Add(new wxStaticText(this, wxID_ANY, _T("&Stop at address:")), 0, wxALIGN_CENTER_VERTICAL);
+	fieldSizer->Add(stopAddress, 0, wxEXPAND);
+	mainSizer->Add(fieldSizer, 0, wxEXPAND | wxALL, 6);
+
+	wxSizer *buttonSizer = CreateButtonSizer(wxOK | wxCANCEL);
+	mainSizer->Add(buttonSizer, 0, wxEXPAND | wxALL, 3);
+	this->Fit();
+}
+
+FastForwardDialog::~FastForwardDialog()
+{
+}
+
+luint FastForwardDialog::getStopAddress()
+{
+	luint address;
+	readStopAddress(address);
+	return address;
+}
+
+bool FastForwardDialog::readStopAddress(luint& address)
+{
+	wxString text = stopAddress->GetValue().Strip(wxString::both);
+	address = Model::NO_STOP_ADDRESS;
+	if(text == _T(""))
+	{
+		return true;
+	}
+	// Only instruction addresses are ever reached, anything else would
+	// silently run every instruction.
+	unsigned long value;
+	if(!text.ToULong(&value, 0) || value % 4 != 0 || value >= Model::MAX_INSTRUCTIONS)
+	{
+		return false;
+	}
+	address = value;
+	return true;
+}
+
+void FastForwardDialog::OnOK(wxCommandEvent& event)
+{
+	luint address;
+	if(!readStopAddress(address))
+	{
+		wxMessageBox(wxString::Format(_T("The stop address must be a multiple of 4 below %u."), Model::MAX_INSTRUCTIONS),
+			_T("Fast Forward"), wxOK | wxICON_ERROR, this);
+		return;
+	}
+	event.Skip();
+}
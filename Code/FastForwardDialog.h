@@ -0,0 +1,53 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef FAST_FORWARD_DIALOG_H_
+#define FAST_FORWARD_DIALOG_H_
+
+#include <wx/wx.h>
+#include <wx/dialog.h>
+#include <wx/spinctrl.h>
+#include <wx/textctrl.h>
+
+#include "Types.h"
+
+// Asks how many instructions Model::fastForward should run, and optionally
+// an address to stop at before that many have run.
+class FastForwardDialog : public wxDialog
+{
+	public:
+		FastForwardDialog(wxWindow* parent, wxIconBundle *ico);
+		virtual ~FastForwardDialog();
+		luint getCount(){ return count->GetValue(); };
+		// Model::NO_STOP_ADDRESS if no address was given.
+		luint getStopAddress();
+	private:
+		// False if the field holds something other than an instruction
+		// address. An empty field gives Model::NO_STOP_ADDRESS.
+		bool readStopAddress(luint& address);
+		void OnOK(wxCommandEvent& event);
+		wxSpinCtrl *count;
+		wxTextCtrl *stopAddress;
+		DECLARE_EVENT_TABLE()
+};
+
+#endif /*FAST_FORWARD_DIALOG_H_*/
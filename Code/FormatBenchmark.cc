@@ -0,0 +1,182 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <chrono>
+
+#include "FormatBenchmark.h"
+
+FormatBenchmark::FormatBenchmark(luint iterations)
+{
+	this->iterations = iterations;
+	// Edge cases for the sign and digit handling, then pseudo-random words.
+	luint edges[] = { 0, 1, 9, 10, 99, 100, 0x7FFF, 0x8000, 0xFFFF, 0x10000,
+		0xFFFF8000, 0x0FFFFFFF, 0x12345678, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF,
+		((luint)1)<<32, ((luint)1)<<63, (luint)(-1) };
+	values.assign(edges, edges + sizeof(edges) / sizeof(edges[0]));
+	luint seed = 12345;
+	while(values.size() < 256)
+	{
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		values.push_back(seed >> 32);
+	}
+}
+
+bool FormatBenchmark::run(std::ostream& out)
+{
+	if(!check(out))
+	{
+		return false;
+	}
+	const char* names[] = { "decimal", "binary", "hex" };
+	numFormat formats[] = { FORMAT_DECIMAL, FORMAT_BINARY, FORMAT_HEX };
+	out << "ns per number over " << iterations << " numbers: reference, convertToBase, convertRangeToBase\n";
+	std::vector<wxString> strings;
+	size_t length = 0;
+	for(uint f = 0; f < 3; f++)
+	{
+		double ns[3];
+		for(uint method = 0; method < 3; method++)
+		{
+			luint numbers = 0;
+			auto start = std::chrono::steady_clock::now();
+			if(method == 2)
+			{
+				for(; numbers < iterations; numbers += values.size())
+				{
+					Maths::convertRangeToBase(values, strings, false, false, formats[f]);
+					length += strings.back().Len();
+				}
+			}
+			else
+			{
+				for(; numbers < iterations; numbers++)
+				{
+					luint value = values[numbers % values.size()];
+					wxString str = (method == 0) ? referenceConvertToBase(value, false, false, formats[f]) : Maths::convertToBase(value, false, false, formats[f]);
+					length += str.Len();
+				}
+			}
+			std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+			ns[method] = time.count() / numbers;
+		}
+		out << names[f] << ": " << ns[0] << " " << ns[1] << " " << ns[2] << "\n";
+	}
+	// Using the output stops the loops being optimised away.
+	out << "characters: " << length << "\n";
+	return true;
+}
+
+bool FormatBenchmark::check(std::ostream& out)
+{
+	bool same = true;
+	for(auto&& i : values)
+	{
+		for(uint f = FORMAT_DECIMAL; f <= FORMAT_HEX; f++)
+		{
+			for(uint options = 0; options < 4; options++)
+			{
+				bool noNegative = !!(options & 1);
+				bool negBit16 = !!(options & 2);
+				wxString expected = referenceConvertToBase(i, noNegative, negBit16, (numFormat)f);
+				wxString actual = Maths::convertToBase(i, noNegative, negBit16, (numFormat)f);
+				if(actual != expected)
+				{
+					out << "mismatch for " << i << ": " << (const char*)expected.mb_str() << " != " << (const char*)actual.mb_str() << "\n";
+					same = false;
+				}
+			}
+		}
+	}
+	return same;
+}
+
+// Maths::convertToBase as it was before being made table driven.
+wxString FormatBenchmark::referenceConvertToBase(luint number, bool noNegative, bool negBit16, numFormat format)
+{
+	uint numNegBits = negBit16 ? 16 : 32;
+	bool negative = !!(number & ((luint)(1)<<(numNegBits - 1)));
+	luint tempNum = negative ? ((luint)(1)<<(numNegBits)) - number : number;
+	wxString decNum, binNum, temp, hexNum;
+	bool foundOne = false;
+	switch(format)
+	{
+		case FORMAT_DECIMAL:
+			if(negative && !noNegative)
+			{
+				decNum += _T("-");
+			}
+			for(uint exp = 0; exp < 10; exp++)
+			{
+				temp += wxString::Format(_T("%u"), uint(tempNum % 10));
+				tempNum = (tempNum - tempNum % 10) / 10;
+			}
+			for(int i = temp.Len() - 1; i >= 0; i--)
+			{
+				if(temp[i] != _T('0'))
+				{
+					foundOne = true;
+				}
+				if(foundOne || i == 0)
+				{
+					decNum += temp[i];
+				}
+			}
+			return decNum;
+		case FORMAT_BINARY:
+			for(luint bit = (((luint)(-1)) >> 1) + 1; bit; bit >>= 1)
+			{
+				temp = bit & number ? _T('1') : _T('0');
+				if(temp == _T('1'))
+				{
+					foundOne = true;
+				}
+				if(foundOne || bit == 1)
+				{
+					binNum += temp;
+				}
+			}
+			return binNum;
+		case FORMAT_HEX:
+			if(negative && !noNegative)
+			{
+				hexNum += _T("-");
+			}
+			for(uint exp = 0; exp < 7; exp++)
+			{
+				temp += wxString::Format(_T("%X"), uint(tempNum % 16));
+				tempNum = (tempNum - tempNum % 16) / 16;
+			}
+			for(int i = temp.Len() - 1; i >= 0; i--)
+			{
+				if(temp[i] != _T('0'))
+				{
+					foundOne = true;
+				}
+				if(foundOne || i == 0)
+				{
+					hexNum += temp[i];
+				}
+			}
+			return hexNum;
+	}
+	return _T("0");
+}
@@ -0,0 +1,51 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef FORMATBENCHMARK_H_
+#define FORMATBENCHMARK_H_
+
+#include <ostream>
+#include <vector>
+
+#include <wx/string.h>
+
+#include "Types.h"
+#include "Maths.h"
+
+// Times Maths::convertToBase against the digit at a time formatter it
+// replaced, after checking that both give the same strings.
+class FormatBenchmark
+{
+	public:
+		FormatBenchmark(luint iterations = DEFAULT_ITERATIONS);
+		// Write the time per number of each formatter for each format to out.
+		// Returns false, without timing, if any output differs.
+		bool run(std::ostream& out);
+		static const luint DEFAULT_ITERATIONS = 1000000;
+	private:
+		bool check(std::ostream& out);
+		static wxString referenceConvertToBase(luint number, bool noNegative, bool negBit16, numFormat format);
+		std::vector<luint> values;
+		luint iterations;
+};
+
+#endif /*FORMATBENCHMARK_H_*/
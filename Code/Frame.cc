@@ -20,14 +20,21 @@
  * 
  */
 
+#include <algorithm>
+
 #include "GLCanvas.h"
 #include "Dialog.h"
+#include "FastForwardDialog.h"
 #include "Datalist.h"
 #include "Model.h"
 #include "Maths.h"
+#include "MemoryTable.h"
 #include "Config.h"
 #include "Icons.h"
 #include "Component.h"
+#include "SimulationWorker.h"
+#include "TimingStats.h"
+#include "ProgramImage.h"
 
 #include "Frame.h"
 
@@ -35,7 +42,14 @@ BEGIN_EVENT_TABLE(Frame, wxFrame)
 	EVT_SPLITTER_SASH_POS_CHANGED(ID_SPLITTER_WINDOW, Frame::OnSplitterSizeChanged)
 	EVT_SPLITTER_SASH_POS_CHANGED(ID_EDSPLITTER_WINDOW, Frame::OnSplitterSizeChanged)
 	EVT_BUTTON(wxID_FORWARD, Frame::StepButtonClicked)
+	EVT_BUTTON(ID_STEP_BACK, Frame::StepBackButtonClicked)
     EVT_BUTTON(wxID_STOP, Frame::ResetButtonClicked)
+    EVT_BUTTON(ID_FAST_FORWARD, Frame::FastForwardButtonClicked)
+    EVT_BUTTON(ID_JUMP_TO_CYCLE, Frame::JumpToCycleButtonClicked)
+    EVT_BUTTON(ID_RUN, Frame::RunButtonClicked)
+    EVT_TIMER(ID_RUN_TIMER, Frame::OnRunTimer)
+    EVT_BUTTON(ID_EXPORT_COUNTERS_CSV, Frame::ExportCounters)
+    EVT_BUTTON(ID_EXPORT_COUNTERS_JSON, Frame::ExportCounters)
     EVT_MENU(ID_MENU_LAYOUT_SIMPLE, Frame::SetSimpleLayout)
     EVT_MENU(ID_MENU_LAYOUT_PIPELINE, Frame::SetPipelineLayout)
     EVT_MENU(ID_MENU_LAYOUT_FORWARDING, Frame::SetForwardingLayout)
@@ -52,14 +66,17 @@ BEGIN_EVENT_TABLE(Frame, wxFrame)
     EVT_BUTTON(ID_PARSE_INSTRUCTIONS, Frame::Parse)
     EVT_GRID_CMD_CELL_CHANGE(ID_MEMORY_LIST, Frame::MemoryGridChanged)
     EVT_LIST_ITEM_SELECTED(ID_INSTRUCTION_LIST, Frame::OnSelectInstruction)
+    EVT_LIST_ITEM_ACTIVATED(ID_INSTRUCTION_LIST, Frame::OnToggleBreakpoint)
 	EVT_SLIDER(ID_ZOOM_SLIDER, Frame::OnZoomSliderChanged)
+	EVT_TEXT(ID_EDITOR_TEXT, Frame::OnEditorTextChanged)
 END_EVENT_TABLE()
 
 Frame::Frame(const wxString& title, const wxPoint& pos, const wxSize& size)
-: wxFrame((wxFrame *)NULL, -1, title, pos, size)
+: wxFrame((wxFrame *)NULL, -1, title, pos, size), runTimer(this, ID_RUN_TIMER)
 {
 	init = false;
 	initSize = false;
+	highlightValid = false;
 	setupMenubar();
 	
 	Config& c = Config::Instance();
@@ -105,8 +122,9 @@ Frame::Frame(const wxString& title, const wxPoint& pos, const wxSize& size)
 	processor->setBool(SHOW_CONTROL_LINES, c.getBool(SHOW_CONTROL_LINES));
 	processor->setBool(SHOW_PC_LINES, c.getBool(SHOW_PC_LINES));
 	processor->setBool(SHOW_POPUPS, c.getBool(SHOW_POPUPS));
-	Component::setAreDataLinesBold(c.getBool(SHOW_BOLD_DATA_LINES));
-	Component::setHighlightSingleInstruction(c.getBool(HIGHLIGHT_SINGLE_INSTRUCTION));
+	processor->setAreDataLinesBold(c.getBool(SHOW_BOLD_DATA_LINES));
+	processor->setHighlightSingleInstruction(c.getBool(HIGHLIGHT_SINGLE_INSTRUCTION));
+	processor->setTimingStats(c.getBool(SHOW_TIMINGS) ? timings.get() : nullptr);
 	
 	// Initialise help
 	help = std::make_unique<wxHtmlHelpController>(wxHF_CONTENTS | wxHF_SEARCH, this);
@@ -167,19 +185,27 @@ void Frame::setupSimulatorPage(wxNotebook *notebook)
     leftPanel->SetMinSize(wxSize(LEFT_PANEL_MIN_WIDTH, LEFT_PANEL_MIN_HEIGHT));
     leftPanel->SetSizer(leftSizer);
     leftSizer->Add(new wxButton(leftPanel, wxID_FORWARD, _T("&Step")), 0, wxEXPAND | wxALL, 0);
+    leftSizer->Add(new wxButton(leftPanel, ID_STEP_BACK, _T("Step &Back")), 0, wxEXPAND | wxALL, 0);
+    runButton = new wxButton(leftPanel, ID_RUN, _T("R&un"));
+    leftSizer->Add(runButton, 0, wxEXPAND | wxALL, 0);
     leftSizer->Add(new wxButton(leftPanel, wxID_STOP, _T("&Reset")), 0, wxEXPAND | wxALL, 0);
+    leftSizer->Add(new wxButton(leftPanel, ID_FAST_FORWARD, _T("&Fast Forward...")), 0, wxEXPAND | wxALL, 0);
+    leftSizer->Add(new wxButton(leftPanel, ID_JUMP_TO_CYCLE, _T("&Jump to Cycle...")), 0, wxEXPAND | wxALL, 0);
     wxNotebook *dataBook = new wxNotebook(leftPanel, wxID_ANY);
     leftSizer->Add(dataBook, 1, wxEXPAND | wxALL, 3);
     wxPanel *instructionPage = new wxPanel(dataBook);
     wxPanel *registerPage = new wxPanel(dataBook);
     wxPanel *dataPage = new wxPanel(dataBook);
+    wxPanel *counterPage = new wxPanel(dataBook);
     dataBook->AddPage(instructionPage, _T("&Instructions"), true);
     dataBook->AddPage(registerPage, _T("&Registers"), false);
+    dataBook->AddPage(counterPage, _T("&Counters"), false);
     dataBook->AddPage(dataPage, _T("&Data"), false);
     
-    dataList[ID_INSTRUCTION_LIST] = new Datalist(4, Model::MAX_INSTRUCTIONS, _T("Instr."), instructionPage, ID_INSTRUCTION_LIST);
-    dataList[ID_REGISTER_LIST] = new Datalist(1, Model::MAX_REGISTERS, _T("Addr."), registerPage, ID_REGISTER_LIST);
-    dataList[ID_DATA_LIST] = new Datalist(1, Model::MAX_DATA, _T("Addr."), dataPage, ID_DATA_LIST);
+    processor = std::make_unique<Model>();
+    dataList[ID_INSTRUCTION_LIST] = new Datalist(processor.get(), ID_INSTRUCTION_LIST, 4, Model::MAX_INSTRUCTIONS, _T("Instr."), instructionPage, ID_INSTRUCTION_LIST);
+    dataList[ID_REGISTER_LIST] = new Datalist(processor.get(), ID_REGISTER_LIST, 1, Model::MAX_REGISTERS, _T("Addr."), registerPage, ID_REGISTER_LIST);
+    dataList[ID_DATA_LIST] = new Datalist(processor.get(), ID_DATA_LIST, 1, Model::MAX_DATA, _T("Addr."), dataPage, ID_DATA_LIST);
     
     wxSizer *instructionSizer = new wxBoxSizer(wxVERTICAL);
     wxSizer *registerSizer = new wxBoxSizer(wxVERTICAL);
@@ -191,12 +217,22 @@ void Frame::setupSimulatorPage(wxNotebook *notebook)
     registerPage->SetSizer(registerSizer);
     dataPage->SetSizer(dataSizer);
 
+    counterList = new wxListCtrl(counterPage, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_SINGLE_SEL);
+    counterList->InsertColumn(0, _T("Counter"));
+    counterList->InsertColumn(1, _T("Value"));
+    wxSizer *counterSizer = new wxBoxSizer(wxVERTICAL);
+    counterSizer->Add(counterList, 1, wxEXPAND | wxALL, 3);
+    counterSizer->Add(new wxButton(counterPage, ID_EXPORT_COUNTERS_CSV, _T("Export CS&V...")), 0, wxEXPAND | wxALL, 0);
+    counterSizer->Add(new wxButton(counterPage, ID_EXPORT_COUNTERS_JSON, _T("Export JS&ON...")), 0, wxEXPAND | wxALL, 0);
+    counterPage->SetSizer(counterSizer);
+
 	// Add a slider for control the zoom of the simulator.
 	leftSizer->Add(new wxSlider(leftPanel, ID_ZOOM_SLIDER, 0, -100, 100), 0, wxEXPAND | wxALL, 0);
         
     // Set up GL canvas.
 	int attribList[] = {WX_GL_RGBA, WX_GL_DOUBLEBUFFER, wxFULL_REPAINT_ON_RESIZE};
-    processor = std::make_unique<Model>();
+    worker = std::make_unique<SimulationWorker>();
+    timings = std::make_unique<TimingStats>();
     processor->resetup();
     canvas = new GLCanvas(processor.get(), mainSplitter, this, wxID_ANY, wxDefaultPosition, 0, _T("GLCanvas"), attribList, wxNullPalette);
    	GLSizer->Add(canvas, 1, wxEXPAND | wxALL, 0);
@@ -240,7 +276,7 @@ void Frame::setupEditorPage(wxNotebook *notebook)
     buttonSizer->Add(new wxButton(parserPane, ID_PARSE_INSTRUCTIONS, _T("&Parse")), 1, wxEXPAND | wxALL, 0);
     
 	// Require wxTE_RICH style for editor text control to allow styling under Windows.
-	editorText = new wxTextCtrl(parserPane, wxID_ANY, _T(""), wxDefaultPosition, wxDefaultSize, wxTE_MULTILINE | wxTE_RICH);
+	editorText = new wxTextCtrl(parserPane, ID_EDITOR_TEXT, _T(""), wxDefaultPosition, wxDefaultSize, wxTE_MULTILINE | wxTE_RICH);
 	errorText = new wxTextCtrl(parserPane, wxID_ANY, _T(""), wxDefaultPosition, wxDefaultSize, wxTE_MULTILINE);
 	
 	parserSizer->Add(buttonSizer, 0, wxEXPAND | wxALL, 3);
@@ -251,16 +287,10 @@ void Frame::setupEditorPage(wxNotebook *notebook)
 
 	// Memory Editor section
 	memoryList = new wxGrid(memoryPane, ID_MEMORY_LIST, wxDefaultPosition, wxDefaultSize);
-	memoryList->CreateGrid(Model::MAX_INSTRUCTIONS, 1);
-	memoryList->SetColLabelValue(0, _T("Data"));
+	memoryList->SetTable(new MemoryTable(processor.get()), true);
 	memoryList->SetColFormatNumber(0);
 	memoryList->SetColSize(0, 240);
 	memoryList->SetRowLabelSize(43);
-	for(uint i = 0; i < Model::MAX_DATA; i++)
-	{
-		memoryList->SetCellValue(i, 0, _T("0"));
-		memoryList->SetRowLabelValue(i, wxString::Format(_T("%d"), i));
-	}
 	memoryList->DisableDragGridSize();
 	memoryList->DisableDragColSize();
 	memoryList->DisableDragRowSize();
@@ -367,21 +397,57 @@ void Frame::updateEditorText()
 
 void Frame::updateEditorTextFromStore()
 {
-	editorText->Clear();
+	wxString text;
+	std::vector<long> starts;
+	std::vector<bool> errors;
 	for(uint i = 0; i < Model::MAX_INSTRUCTIONS; i+=4)
 	{
 		wxString instr;
 		bool err;
 		processor->getInstructionString(i, instr, err);
+		starts.push_back(text.Len());
+		errors.push_back(err);
+		text += instr;
+	}
+	starts.push_back(text.Len());
+
+	// Replace only the text between the parts the editor already has, so
+	// reparsing an unchanged program leaves the editor and its highlighting
+	// alone.
+	wxString old = editorText->GetValue();
+	size_t common = std::min(old.Len(), text.Len());
+	size_t prefix = 0;
+	while(prefix < common && old[prefix] == text[prefix])
+	{
+		prefix++;
+	}
+	size_t suffix = 0;
+	while(suffix < common - prefix && old[old.Len() - 1 - suffix] == text[text.Len() - 1 - suffix])
+	{
+		suffix++;
+	}
+	bool changed = (prefix != old.Len() || prefix != text.Len());
+	if(changed)
+	{
+		editorText->Replace(prefix, old.Len() - suffix, text.Mid(prefix, text.Len() - suffix - prefix));
+	}
+	if(changed || errors != editorErrors)
+	{
+		editorText->SetStyle(0, text.Len(), wxTextAttr(editorText->GetForegroundColour()));
 		wxTextAttr textAttr1 = wxTextAttr(wxColour(255, 0, 0));
-		editorText->AppendText(instr);
-		if(err)
+		for(uint i = 0; i < errors.size(); i++)
 		{
-			int lastPos = editorText->GetLastPosition();
-			editorText->SetStyle(lastPos - instr.Len(), lastPos, textAttr1);
+			if(errors[i])
+			{
+				editorText->SetStyle(starts[i], starts[i + 1], textAttr1);
+			}
 		}
+		editorErrors = errors;
+	}
+	if(changed)
+	{
+		editorText->SetInsertionPoint(0);
 	}
-	editorText->SetInsertionPoint(0);
 }
 
 void Frame::updateErrorText()
@@ -421,152 +487,164 @@ void Frame::updateErrorText()
 
 void Frame::updateDataList(bool initialCall, bool selectInstruction)
 {
+	ScopedTiming timing(processor->getTimingStats(), TIMING_DATA_LIST);
+	if(initialCall)
+	{
+		highlightValid = false;
+	}
 	for(const auto& dl: dataList)
 	{
-		uint cMem = dl.first;
 		Datalist* list = dl.second;
 
-		// For complete redraw, completely empty datalist then refill with columns.
+		// For complete redraw, rebuild the columns and every row.
 		if(initialCall)
 		{
-			list->DeleteAllItems();
 			while(list->GetColumnCount() > 0)
 			{
 				list->DeleteColumn(0);
 			}
 			list->InsertFirstColumn();
 			list->InsertColumn(1, _T("Data"));
+			list->resetItems();
 		}
-		
-		uint maxVals = list->getMaxVals();
-		uint multiplier = list->getMultiplier();
-		wxString val;
-		for(uint i = 0; i < maxVals; i++)
+		else
 		{
-			// Insert items for complete redraw.
-			if(initialCall)
-			{
-				list->InsertItem(i, wxString::Format(_T("%d"), i * multiplier));
-				
-				// Keep selected item between removing and reinserting all the rows. 
-				if(list->getSelectedIndex() == i * multiplier)
-				{
-					list->SetItemState(i, wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED);
-				}
-			}
-			
-			// Get raw data for data list.
-			if(cMem != ID_INSTRUCTION_LIST)
-			{
-				val = Maths::convertToBase(processor->getMemoryData(cMem, i * multiplier));
-			}
-			else
-			{
-				val = Maths::convertToBase(processor->getMemoryData(cMem, i * multiplier), true);
-			}
-			
-			// Get fielded instructions if we're getting instructions and we want fields.
-			if(cMem == ID_INSTRUCTION_LIST && initialCall && processor->getBool(SHOW_INSTRUCTION_FIELDS))
-			{
-				processor->getFieldedInstruction(i * multiplier, val);
-			}
-
-			// Update item unless it is instructions & not a complete redraw.
-			if(!(cMem == ID_INSTRUCTION_LIST && !initialCall))
-			{
-				list->SetItem(i, 1, val);
-			}
+			list->refreshChanged();
 		}
 	}
 	updateDataListHighlighting();
+	updateCounterList();
 }
 
-void Frame::updateDataListHighlighting()
+void Frame::updateDataListAfterStep()
 {
-	processor->setHighlightInstruction(dataList[ID_INSTRUCTION_LIST]->getSelectedIndex(), dataList[ID_INSTRUCTION_LIST]->isSelectedIndexValid());
-	uint curPos = 0;
-	uint multiplier = dataList[ID_INSTRUCTION_LIST]->getMultiplier();
-	uint maxVals = dataList[ID_INSTRUCTION_LIST]->getMaxVals();
-	wxColour col;
-	for(uint i = 0; i < maxVals; i++)
-	{
-		uint lineLength = editorText->GetLineLength(i);
-		col = processor->getColourForInstruction(i * multiplier);
-		// Set background colour for current instruction to red in left panel.
-		dataList[ID_INSTRUCTION_LIST]->SetItemBackgroundColour(i, col);
-		wxTextAttr textAttr1 = wxTextAttr(wxNullColour, col);
-		textAttr1.SetFlags(wxTEXT_ATTR_BACKGROUND_COLOUR);
-		editorText->SetStyle(curPos, curPos + lineLength, textAttr1);
-		curPos += lineLength + 1;
+	ScopedTiming timing(processor->getTimingStats(), TIMING_DATA_LIST);
+	// Only the rows the step wrote need redrawing.
+	for(const auto& dl: dataList)
+	{
+		dl.second->refreshWrites(processor->getMemoryWrites());
 	}
+	updateDataListHighlighting();
+	updateCounterList();
 }
 
-void Frame::setInitialMemoryVals(bool fromParser)
+void Frame::updateCounterList()
 {
-	if(fromParser)
+	PerformanceCounters& counters = processor->getCounters();
+	const wxString labels[] = {_T("Cycles"), _T("Retired"), _T("Branch flushes"), _T("Forward A"), _T("Forward B"), _T("Bubbles")};
+	if(counterList->GetItemCount() == 0)
 	{
-		for(uint i = 0; i < Model::MAX_INSTRUCTIONS; i++)
+		for(uint i = COUNTER_MIN; i < COUNTER_MAX; i++)
 		{
-			processor->setMemoryData(2, i, processor->getParserMemData(i));
-			memoryList->SetCellValue(i, 0, Maths::convertToBase(processor->getParserMemData(i), false, false, FORMAT_DECIMAL));
+			counterList->InsertItem(i, labels[i]);
 		}
+		counterList->InsertItem(COUNTER_MAX, _T("CPI"));
 	}
-	luint numVal;
-	bool minus;
-	long unsigned int tempNum;
-	for(uint i = 0; i < Model::MAX_INSTRUCTIONS; i++)
-	{
-		// Stuff to make this work properly with correct limits on 32 bit systems.
-		wxString val = memoryList->GetCellValue(i, 0);
-		int numLen = val.Len();
-		numVal = 0;
-		minus = false;
-		for(int j = 0; j < numLen; j++)
-		{
-			uint pos = numLen - j - 1;
-			wxString chara = val[pos];
-			if(pos == 0 && chara == _T('-'))
-			{
-				minus = true;
-			}
-			chara.ToULong(&tempNum);
-			numVal += (uint)(pow(10.0, j)) * tempNum;
-		}
-		bool numValSizeOk = (0 <= numVal && numVal <= Model::MAX_MEM_VAL / 2);
-		if(minus)
+	for(uint i = COUNTER_MIN; i < COUNTER_MAX; i++)
+	{
+		counterList->SetItem(i, 1, wxString::Format(_T("%lu"), (unsigned long)counters.get((Counter)i)));
+	}
+	counterList->SetItem(COUNTER_MAX, 1, wxString::Format(_T("%.3f"), counters.getCPI()));
+}
+
+void Frame::updateDataListHighlighting()
+{
+	ScopedTiming timing(processor->getTimingStats(), TIMING_HIGHLIGHTING);
+	Datalist* list = dataList[ID_INSTRUCTION_LIST];
+	processor->setHighlightInstruction(list->getSelectedIndex(), list->isSelectedIndexValid());
+	uint multiplier = list->getMultiplier();
+	uint maxVals = list->getMaxVals();
+	// Only the rows that were or are now in the pipeline can have changed
+	// colour, unless everything has to be restyled.
+	std::vector<luint> rows;
+	if(!highlightValid)
+	{
+		highlightColours.assign(maxVals, wxNullColour);
+		editorLineStarts.assign(maxVals + 1, 0);
+		for(uint i = 0; i < maxVals; i++)
 		{
-			// convert number to 2's complement negative number.
-			numVal = ((luint)(1)<<32) - numVal;
+			// Lines past the end have a length of -1, so take no space.
+			long lineLength = editorText->GetLineLength(i);
+			editorLineStarts[i + 1] = editorLineStarts[i] + lineLength + 1;
+			rows.push_back(i);
 		}
-		if(numVal && val.ToULong(&tempNum) && numValSizeOk)
+		highlightValid = true;
+	}
+	else
+	{
+		rows = highlightedRows;
+	}
+	std::vector<luint> addresses;
+	processor->getPipelineAddresses(addresses);
+	highlightedRows.clear();
+	for(auto&& address : addresses)
+	{
+		if(address % multiplier == 0 && address / multiplier < maxVals)
 		{
-			processor->setMemoryData(2, i, numVal);
-			processor->setParserMemData(i, numVal);
+			highlightedRows.push_back(address / multiplier);
 		}
-		else
+	}
+	rows.insert(rows.end(), highlightedRows.begin(), highlightedRows.end());
+	for(auto&& i : rows)
+	{
+		wxColour col = processor->getColourForInstruction(i * multiplier);
+		if(col == highlightColours[i])
 		{
-			processor->setMemoryData(2, i, 0);
-			processor->setParserMemData(i, 0);
-			memoryList->SetCellValue(i, 0, _T("0"));
+			continue;
 		}
+		highlightColours[i] = col;
+		// The list colours its rows itself as they are drawn.
+		list->RefreshItem(i);
+		wxTextAttr textAttr1 = wxTextAttr(wxNullColour, col);
+		textAttr1.SetFlags(wxTEXT_ATTR_BACKGROUND_COLOUR);
+		editorText->SetStyle(editorLineStarts[i], editorLineStarts[i + 1] - 1, textAttr1);
 	}
 }
 
+void Frame::OnEditorTextChanged(wxCommandEvent& event)
+{
+	highlightValid = false;
+	event.Skip();
+}
+
+void Frame::setInitialMemoryVals()
+{
+	processor->loadInitialData();
+	memoryList->ForceRefresh();
+}
+
 void Frame::MemoryGridChanged(wxGridEvent& WXUNUSED(event))
 {
+	stopRun();
 	setInitialMemoryVals();
 	updateDataList();
 }
 
 void Frame::StepButtonClicked(wxCommandEvent& WXUNUSED(event))
 {
+	stopRun();
 	processor->step();
-	updateDataList();
+	updateDataListAfterStep();
 	canvas->Render();
 }
 
+void Frame::StepBackButtonClicked(wxCommandEvent& WXUNUSED(event))
+{
+	stopRun();
+	if(processor->stepBack())
+	{
+		updateDataListAfterStep();
+		canvas->Render();
+	}
+	else
+	{
+		wxBell();
+	}
+}
+
 void Frame::ResetButtonClicked(wxCommandEvent& WXUNUSED(event))
 {
+	stopRun();
 	processor->resetup();
 	setInitialMemoryVals();
 	processor->getParsedInstructions();
@@ -574,8 +652,91 @@ void Frame::ResetButtonClicked(wxCommandEvent& WXUNUSED(event))
 	canvas->Render();
 }
 
+void Frame::FastForwardButtonClicked(wxCommandEvent& WXUNUSED(event))
+{
+	FastForwardDialog dlg(this, ico.get());
+	if(dlg.ShowModal() == wxID_OK)
+	{
+		stopRun();
+		// The interpreter starts from the initial memory data, as Reset does.
+		setInitialMemoryVals();
+		processor->fastForward(dlg.getCount(), dlg.getStopAddress());
+		updateDataList();
+		canvas->Render();
+	}
+}
+
+void Frame::JumpToCycleButtonClicked(wxCommandEvent& WXUNUSED(event))
+{
+	stopRun();
+	History& history = processor->getHistory();
+	wxString message = wxString::Format(_T("Cycles from %lu can be returned to without a reset,\n")
+		_T("and up to %lu cycles ahead. Use Fast Forward to go further.\n")
+		_T("History holds %lu cycles in %lu KB (%lu bytes per cycle)."),
+		(unsigned long)processor->getOldestCycle(), (unsigned long)Model::MAX_JUMP_AHEAD, (unsigned long)history.getNumCycles(),
+		(unsigned long)(history.getBytesUsed() / 1024), (unsigned long)history.getBytesPerCycle());
+	long target = wxGetNumberFromUser(message, _T("Cycle:"), _T("Jump to Cycle"),
+		(long)processor->getCycle(), (long)processor->getOldestCycle(), (long)(processor->getCycle() + Model::MAX_JUMP_AHEAD), this);
+	if(target >= 0)
+	{
+		processor->jumpToCycle(target);
+		updateDataList();
+		canvas->Render();
+	}
+}
+
+void Frame::RunButtonClicked(wxCommandEvent& WXUNUSED(event))
+{
+	if(runTimer.IsRunning())
+	{
+		stopRun();
+	}
+	else
+	{
+		runButton->SetLabel(_T("St&op"));
+		worker->start(*processor);
+		runTimer.Start(RUN_REFRESH_MS);
+	}
+}
+
+void Frame::OnRunTimer(wxTimerEvent& WXUNUSED(event))
+{
+	// The worker does the simulating, only show the latest whole step it
+	// has published so the display costs the same however fast it runs.
+	if(worker->hasStopped())
+	{
+		stopRun();
+	}
+	else if(worker->update(*processor))
+	{
+		updateDataList();
+		canvas->Render();
+	}
+}
+
+void Frame::stopRun()
+{
+	if(runTimer.IsRunning())
+	{
+		runTimer.Stop();
+		runButton->SetLabel(_T("R&un"));
+		worker->stop(*processor);
+		updateDataList();
+		canvas->Render();
+	}
+}
+
+void Frame::OnToggleBreakpoint(wxListEvent& event)
+{
+	stopRun();
+	processor->toggleBreakpoint(event.GetIndex() * dataList[ID_INSTRUCTION_LIST]->getMultiplier());
+	highlightValid = false;
+	updateDataListHighlighting();
+}
+
 void Frame::SetSimpleLayout(wxCommandEvent& WXUNUSED(event))
 {
+	stopRun();
 	processor->resetup(LAYOUT_SIMPLE);
 	Config& c = Config::Instance();
 	c.setBool(SHOW_SIMPLE_LAYOUT, true);
@@ -589,6 +750,7 @@ void Frame::SetSimpleLayout(wxCommandEvent& WXUNUSED(event))
 
 void Frame::SetPipelineLayout(wxCommandEvent& WXUNUSED(event))
 {
+	stopRun();
 	processor->resetup(LAYOUT_PIPELINE);
 	Config& c = Config::Instance();
 	c.setBool(SHOW_SIMPLE_LAYOUT, false);
@@ -602,6 +764,7 @@ void Frame::SetPipelineLayout(wxCommandEvent& WXUNUSED(event))
 
 void Frame::SetForwardingLayout(wxCommandEvent& WXUNUSED(event))
 {
+	stopRun();
 	processor->resetup(LAYOUT_FORWARDING);
 	Config& c = Config::Instance();
 	c.setBool(SHOW_SIMPLE_LAYOUT, false);
@@ -668,6 +831,7 @@ void Frame::showHideLeftPanel(bool showLeftPanel, bool justSwitch)
 
 void Frame::EditOptions(wxCommandEvent& WXUNUSED(event))
 {
+	stopRun();
 	Dialog *dlg = new Dialog(this, wxID_ANY, ico.get(), processor.get(), _T("Options"), mainSplitter->IsSplit(), processor->getBool(SHOW_INSTRUCTION_FIELDS));
 	Config &c = Config::Instance();
 		
@@ -682,17 +846,19 @@ void Frame::EditOptions(wxCommandEvent& WXUNUSED(event))
 		c.setBool(SHOW_PC_LINES, dlg->getBool(SHOW_PC_LINES));
 		processor->setBool(SHOW_POPUPS, dlg->getBool(SHOW_POPUPS));
 		c.setBool(SHOW_POPUPS, dlg->getBool(SHOW_POPUPS));
-		Component::setAreDataLinesBold(dlg->getBool(SHOW_BOLD_DATA_LINES));
+		processor->setAreDataLinesBold(dlg->getBool(SHOW_BOLD_DATA_LINES));
 		c.setBool(SHOW_BOLD_DATA_LINES, dlg->getBool(SHOW_BOLD_DATA_LINES));
-		Component::setHighlightSingleInstruction(dlg->getBool(HIGHLIGHT_SINGLE_INSTRUCTION));
+		processor->setHighlightSingleInstruction(dlg->getBool(HIGHLIGHT_SINGLE_INSTRUCTION));
 		c.setBool(HIGHLIGHT_SINGLE_INSTRUCTION, dlg->getBool(HIGHLIGHT_SINGLE_INSTRUCTION));
+		processor->setTimingStats(dlg->getBool(SHOW_TIMINGS) ? timings.get() : nullptr);
+		c.setBool(SHOW_TIMINGS, dlg->getBool(SHOW_TIMINGS));
 
 		for(uint n = CONFIG_MIN_NAME; n < CONFIG_MAX_NAME; ++n)
 		{
 			if(c.isNameAColour((configName)n))
 			{
 				c.setColour((configName)n, dlg->getColour((configName)n));
-				Component::setColour((configName)n, dlg->getColour((configName)n));
+				processor->setColour((configName)n, dlg->getColour((configName)n));
 			}
 		}
 		processor->resetColours();
@@ -708,7 +874,8 @@ void Frame::EditOptions(wxCommandEvent& WXUNUSED(event))
 
 void Frame::LoadFile(wxCommandEvent& event)
 {
-	wxFileDialog openDlg(this, _T("Load Instruction File"), _T(""), _T(""), _T("Definition files (*.def)|*.def"), wxFD_OPEN);
+	stopRun();
+	wxFileDialog openDlg(this, _T("Load Instruction File"), _T(""), _T(""), _T("Definition files (*.def)|*.def|Program images (*.mipsimg)|*.mipsimg"), wxFD_OPEN);
 	if(openDlg.ShowModal() == wxID_OK)
 	{
 		if(openDlg.GetPath().c_str() != _T(""))
@@ -716,13 +883,17 @@ void Frame::LoadFile(wxCommandEvent& event)
 			processor->loadFile(openDlg.GetPath());
 			processor->parse(_T(""));
 			processor->resetup();
-			setInitialMemoryVals(true);
+			setInitialMemoryVals();
 			canvas->Render();
 			updateDataList(true, true);
 			updateEditorTextFromStore();
 			updateErrorText();
 			resetLeftPanelSizes();
-			Parse(event);
+			// An image is already assembled, reparsing its text gains nothing.
+			if(!ProgramImage::isImageFile(openDlg.GetPath()))
+			{
+				Parse(event);
+			}
 		}
 	}
 }
@@ -730,35 +901,55 @@ void Frame::LoadFile(wxCommandEvent& event)
 void Frame::SaveFile(wxCommandEvent& event)
 {
 	Parse(event);
-	wxFileDialog saveDlg(this, _T("Save Instruction File"), _T(""), _T(""), _T("Definition files (*.def)|*.def"), wxFD_SAVE);
+	wxFileDialog saveDlg(this, _T("Save Instruction File"), _T(""), _T(""), _T("Definition files (*.def)|*.def|Program images (*.mipsimg)|*.mipsimg"), wxFD_SAVE);
 	if(saveDlg.ShowModal() == wxID_OK)
 	{
 		wxString path = saveDlg.GetPath();
 		if(path.c_str() != _T(""))
 		{
-			if(path.Right(4) != _T(".def"))
+			// Add the extension of the chosen file type.
+			wxString extension = (saveDlg.GetFilterIndex() == 1) ? _T(".mipsimg") : _T(".def");
+			if(!path.EndsWith(extension))
 			{
-				path += _T(".def");
+				path += extension;
 			}
 			// Check to see if the file exists. If it does, warn about overwriting it.
 			std::ifstream checkfile(path.fn_str());
 			checkfile.close();
+			bool save = true;
 			if(!checkfile.fail())
 			{
 				wxMessageDialog overwrite(this, saveDlg.GetFilename() + _T(" already exists.\nDo you want to replace it?"), _T("Warning"), wxYES_NO | wxICON_EXCLAMATION);
-				if(overwrite.ShowModal() == wxID_YES)
-				{
-					processor->saveFile(path);
-				}
+				save = (overwrite.ShowModal() == wxID_YES);
 			}
-			else
+			if(save && !processor->saveFile(path))
 			{
-				processor->saveFile(path);
+				wxMessageDialog failed(this, saveDlg.GetFilename() + _T(" could not be written."), _T("Error"), wxOK | wxICON_ERROR);
+				failed.ShowModal();
 			}
 		}
 	}
 }
 
+void Frame::ExportCounters(wxCommandEvent& event)
+{
+	bool json = (event.GetId() == ID_EXPORT_COUNTERS_JSON);
+	wxFileDialog saveDlg(this, _T("Export Counters"), _T(""), _T(""),
+		json ? _T("JSON files (*.json)|*.json") : _T("CSV files (*.csv)|*.csv"), wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+	if(saveDlg.ShowModal() == wxID_OK)
+	{
+		std::ofstream file(saveDlg.GetPath().fn_str());
+		if(json)
+		{
+			processor->getCounters().writeJSON(file);
+		}
+		else
+		{
+			processor->getCounters().writeCSV(file);
+		}
+	}
+}
+
 void Frame::ShowContents(wxCommandEvent& WXUNUSED(event))
 {
 	help->DisplayContents();
@@ -781,12 +972,22 @@ void Frame::ShowAbout(wxCommandEvent& WXUNUSED(event))
 
 void Frame::Parse(wxCommandEvent& WXUNUSED(event))
 {
+	stopRun();
 	wxString str = editorText->GetValue();
-	processor->parse(str);
-	processor->resetup();
-	setInitialMemoryVals();
-	canvas->Render();
-	updateDataList(true, true);
+	if(processor->reassemble(str))
+	{
+		// Only the instructions that changed were written.
+		canvas->Render();
+		updateDataList();
+	}
+	else
+	{
+		processor->parse(str);
+		processor->resetup();
+		setInitialMemoryVals();
+		canvas->Render();
+		updateDataList(true, true);
+	}
 	updateEditorTextFromStore();
 	updateErrorText();
 	resetLeftPanelSizes();
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <wx/wx.h>
 #include <wx/icon.h>
@@ -44,6 +45,8 @@
 #include <wx/html/helpctrl.h>
 #include <wx/fs_arc.h>
 #include <wx/accel.h>
+#include <wx/numdlg.h>
+#include <wx/timer.h>
 
 #include "Enums.h"
 #include "Types.h"
@@ -52,6 +55,8 @@ class GLCanvas;
 class ScrolledWindow;
 class Model;
 class Datalist;
+class SimulationWorker;
+class TimingStats;
 
 class Frame : public wxFrame
 {
@@ -60,10 +65,20 @@ public:
 	virtual ~Frame();
     void showHideLeftPanel(bool showLeftPanel, bool justSwitch = false);
     void updateDataList(bool initialCall = false, bool selectInstruction = false);
+    // As updateDataList(), after a single step or step back.
+    void updateDataListAfterStep();
     void finishInit();
+    void stopRun();
 private:
     void StepButtonClicked(wxCommandEvent& event);
+    void StepBackButtonClicked(wxCommandEvent& event);
     void ResetButtonClicked(wxCommandEvent& event);
+    void FastForwardButtonClicked(wxCommandEvent& event);
+    void JumpToCycleButtonClicked(wxCommandEvent& event);
+    void RunButtonClicked(wxCommandEvent& event);
+    void OnRunTimer(wxTimerEvent& event);
+    void ExportCounters(wxCommandEvent& event);
+    void OnToggleBreakpoint(wxListEvent& event);
     void SetSimpleLayout(wxCommandEvent& event);
     void SetPipelineLayout(wxCommandEvent& event);
     void SetForwardingLayout(wxCommandEvent& event);
@@ -84,18 +99,23 @@ private:
 	void updateEditorText();
 	void updateEditorTextFromStore();
 	void updateErrorText();
-	void setInitialMemoryVals(bool fromParser = false);
+	void setInitialMemoryVals();
 	void resetLeftPanelSizes();
 	void OnSplitterSizeChanged(wxSplitterEvent& event);
 	void OnSelectInstruction(wxListEvent& event);
 	void OnZoomSliderChanged(wxCommandEvent& event);
 	void updateDataListHighlighting();
+	void OnEditorTextChanged(wxCommandEvent& event);
+	void updateCounterList();
 	static const int LEFT_PANEL_DEFAULT_SIZE=100;
 	static const int LEFT_PANEL_MIN_WIDTH=213;
 	static const int LEFT_PANEL_MIN_HEIGHT=450;
+	static const int RUN_REFRESH_MS=33;       // Redraw at about 30Hz while running.
 	GLCanvas *canvas;
 	wxGridSizer *GLSizer;
 	std::unique_ptr<Model> processor;
+	std::unique_ptr<SimulationWorker> worker;	// Steps a copy of processor while running.
+	std::unique_ptr<TimingStats> timings;		// Shown by the canvas when SHOW_TIMINGS is set.
 	wxPanel *leftPanel;
 	wxPanel *memoryPane;
 	wxSplitterWindow *mainSplitter;
@@ -103,11 +123,21 @@ private:
 	wxTextCtrl *editorText;
 	wxTextCtrl *errorText;
 	std::map<uint, Datalist*> dataList;
+	wxListCtrl *counterList;
 	wxGrid *memoryList;
 	std::unique_ptr<wxHtmlHelpController> help;
 	std::unique_ptr<wxIconBundle> ico;
+	wxTimer runTimer;
+	wxButton *runButton;
 	bool init;
 	bool initSize;
+	// Instruction highlighting as last shown, so a step only restyles the
+	// rows that change. Rebuilt in full when highlightValid is cleared.
+	bool highlightValid;
+	std::vector<wxColour> highlightColours;
+	std::vector<luint> highlightedRows;		// Rows of the last pipeline addresses.
+	std::vector<long> editorLineStarts;		// Offset of each editor line, and the end.
+	std::vector<bool> editorErrors;			// Instructions shown in red in the editor.
     DECLARE_EVENT_TABLE()
 };
 
@@ -139,10 +169,18 @@ enum
     ID_LOAD_INSTRUCTIONS,
     ID_SAVE_INSTRUCTIONS,
     ID_PARSE_INSTRUCTIONS,
+    ID_STEP_BACK,
+    ID_FAST_FORWARD,
+    ID_JUMP_TO_CYCLE,
+    ID_RUN,
+    ID_RUN_TIMER,
+    ID_EXPORT_COUNTERS_CSV,
+    ID_EXPORT_COUNTERS_JSON,
     ID_MEMORY_LIST,
     ID_SPLITTER_WINDOW,
     ID_EDSPLITTER_WINDOW,
-	ID_ZOOM_SLIDER
+	ID_ZOOM_SLIDER,
+	ID_EDITOR_TEXT
 };
 
 #endif /*FRAME_H_*/
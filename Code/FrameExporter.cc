@@ -0,0 +1,205 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <wx/image.h>
+#include <wx/graphics.h>
+
+#include "Config.h"
+#include "Model.h"
+#include "ThreadPool.h"
+#include "GeometryCache.h"
+#include "GLRenderer.h"
+
+#include "FrameExporter.h"
+
+// Same as the canvas at a zoom of 0.
+const double FrameExporter::DEFAULT_SCALE = 5.5;
+
+FrameExporter::FrameExporter(Layout layout, luint maxCycles, uint numThreads)
+	: pool(std::make_unique<ThreadPool>(numThreads))
+{
+	this->layout = layout;
+	this->maxCycles = maxCycles;
+	inFlight = 0;
+	// Enough queued frames to keep every worker busy.
+	maxInFlight = 2 * pool->getNumThreads();
+	scale = DEFAULT_SCALE;
+	writePNG = true;
+	writeSVG = false;
+	Config::Instance();
+}
+
+FrameExporter::~FrameExporter()
+{
+	/* Nothing to do. */
+}
+
+luint FrameExporter::exportProgram(wxString file, wxString prefix)
+{
+	Model processor;
+	processor.getHistory().setMaxBytes(0);
+	Config &c = Config::Instance();
+	processor.setBool(SHOW_CONTROL_LINES, c.getBool(SHOW_CONTROL_LINES));
+	processor.setBool(SHOW_PC_LINES, c.getBool(SHOW_PC_LINES));
+	processor.setAreDataLinesBold(c.getBool(SHOW_BOLD_DATA_LINES));
+	processor.setHighlightSingleInstruction(c.getBool(HIGHLIGHT_SINGLE_INSTRUCTION));
+	processor.resetup(layout);
+	if(!processor.loadProgram(file))
+	{
+		return 0;
+	}
+	luint end = processor.getProgramEnd();
+
+	// Leave a small border around the layout.
+	processor.getLayoutBounds(min, max);
+	min = Coord(min.x - 5, min.y - 5);
+	max = Coord(max.x + 5, max.y + 5);
+
+	std::string base((const char*)prefix.mb_str());
+	luint frames = 0;
+	GeometryCache cache;
+	while(true)
+	{
+		cache.clear();
+		processor.draw(cache, wxPoint(0, 0), scale / DEFAULT_SCALE);
+		char number[16];
+		std::snprintf(number, sizeof(number), "_%05lu", (unsigned long)processor.getCycle());
+		exportFrame(cache, base + number);
+		frames++;
+		if(processor.getCounters().get(COUNTER_CYCLES) >= maxCycles || processor.atEnd(end))
+		{
+			break;
+		}
+		processor.step();
+	}
+	pool->wait();
+	return frames;
+}
+
+void FrameExporter::exportFrame(const GeometryCache& cache, const std::string& name)
+{
+	// Only plain data is handed to the pool; the GUI objects are built here.
+	if(writeSVG)
+	{
+		auto svg = std::make_shared<std::string>();
+		std::ostringstream out;
+		cache.writeSVG(out, min, max, scale, GLRenderer::TEXT_PIXELS / DEFAULT_SCALE);
+		*svg = out.str();
+		submit([svg, name]{
+			std::ofstream file((name + ".svg").c_str());
+			file << *svg;
+		});
+	}
+	if(writePNG)
+	{
+		auto image = std::make_shared<wxImage>((int)((max.x - min.x) * scale + 0.5), (int)((max.y - min.y) * scale + 0.5));
+		rasterise(cache, *image);
+		submit([image, name]{
+			image->SaveFile(wxString((name + ".png").c_str(), wxConvUTF8), wxBITMAP_TYPE_PNG);
+		});
+	}
+}
+
+void FrameExporter::rasterise(const GeometryCache& cache, wxImage& image)
+{
+	const std::vector<float>& positions = cache.getPositions();
+	const std::vector<float>& colours = cache.getColours();
+	auto toColour = [](const float* c)
+	{
+		return wxColour((unsigned char)(c[0] * 255 + 0.5), (unsigned char)(c[1] * 255 + 0.5), (unsigned char)(c[2] * 255 + 0.5), (unsigned char)(c[3] * 255 + 0.5));
+	};
+	auto x = [&](uint v){ return (positions[2 * v] - min.x) * scale; };
+	auto y = [&](uint v){ return (max.y - positions[2 * v + 1]) * scale; };
+
+	// The image is updated when the context is destroyed.
+	std::unique_ptr<wxGraphicsContext> gc(wxGraphicsContext::Create(image));
+	gc->SetAntialiasMode(wxANTIALIAS_DEFAULT);
+	for(auto&& batch : cache.getBatches())
+	{
+		// Runs of primitives of one colour go in one path, so that the
+		// triangles of a shape do not show antialiased seams.
+		uint step = (batch.mode == GEOMETRY_TRIANGLES) ? 3 : (batch.mode == GEOMETRY_LINES) ? 2 : batch.count;
+		uint end = batch.first + batch.count;
+		uint v = batch.first;
+		while(step != 0 && v + step <= end)
+		{
+			const float* colour = &colours[4 * v];
+			wxGraphicsPath path = gc->CreatePath();
+			do
+			{
+				path.MoveToPoint(x(v), y(v));
+				for(uint i = 1; i < step; ++i)
+				{
+					path.AddLineToPoint(x(v + i), y(v + i));
+				}
+				if(batch.mode != GEOMETRY_LINES)
+				{
+					path.CloseSubpath();
+				}
+				v += step;
+			}
+			while(v + step <= end && std::memcmp(colour, &colours[4 * v], 4 * sizeof(float)) == 0);
+			if(batch.mode == GEOMETRY_LINES)
+			{
+				gc->SetPen(wxPen(toColour(colour), std::max(1, (int)(batch.lineWidth + 0.5))));
+				gc->StrokePath(path);
+			}
+			else
+			{
+				gc->SetBrush(wxBrush(toColour(colour)));
+				gc->FillPath(path, wxWINDING_RULE);
+			}
+		}
+	}
+	int textPixels = std::max(1, (int)(GLRenderer::TEXT_PIXELS * scale / DEFAULT_SCALE + 0.5));
+	wxFont font(wxSize(0, textPixels), wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+	for(auto&& text : cache.getTexts())
+	{
+		gc->SetFont(font, toColour(text.colour.c));
+		wxDouble w, h, descent, leading;
+		gc->GetTextExtent(text.text, &w, &h, &descent, &leading);
+		// DrawText places the top of the text, the cache holds the baseline.
+		gc->DrawText(text.text, (text.x - min.x) * scale, (max.y - text.y) * scale - (h - descent));
+	}
+}
+
+void FrameExporter::submit(std::function<void()> task)
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		frameDone.wait(lock, [this]{ return inFlight < maxInFlight; });
+		inFlight++;
+	}
+	pool->submit([this, task]{
+		task();
+		std::lock_guard<std::mutex> lock(mutex);
+		inFlight--;
+		frameDone.notify_one();
+	});
+}
@@ -0,0 +1,79 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef FRAME_EXPORTER_H_
+#define FRAME_EXPORTER_H_
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <wx/string.h>
+
+#include "Types.h"
+#include "Enums.h"
+#include "Coord.h"
+
+class GeometryCache;
+class ThreadPool;
+class wxImage;
+
+// Writes the datapath after every step of a program as numbered PNG and SVG
+// files, without a window. The model is stepped and each frame drawn on the
+// calling thread, while the PNG encoding and file writes of earlier frames
+// run on a thread pool.
+class FrameExporter
+{
+	public:
+		FrameExporter(Layout layout = LAYOUT_SIMPLE, luint maxCycles = DEFAULT_MAX_CYCLES, uint numThreads = 0);
+		~FrameExporter();
+		// Size in pixels of one layout unit.
+		void setScale(double scale){ this->scale = scale; };
+		void setWritePNG(bool png){ writePNG = png; };
+		void setWriteSVG(bool svg){ writeSVG = svg; };
+		// Export one program to <prefix>_<cycle>.png / .svg, finishing when
+		// it has run past its last instruction, as Model::atEnd() finds it,
+		// or at the cycle limit in clock cycles.
+		// Returns the number of frames, or 0 if the program has errors.
+		luint exportProgram(wxString file, wxString prefix);
+		static const luint DEFAULT_MAX_CYCLES = 1000;
+		static const double DEFAULT_SCALE;
+	private:
+		void exportFrame(const GeometryCache& cache, const std::string& name);
+		void rasterise(const GeometryCache& cache, wxImage& image);
+		void submit(std::function<void()> task);
+		std::unique_ptr<ThreadPool> pool;
+		std::mutex mutex;
+		std::condition_variable frameDone;
+		uint inFlight;	// Frames handed to the pool and not yet written.
+		uint maxInFlight;
+		Layout layout;
+		luint maxCycles;
+		double scale;
+		bool writePNG;
+		bool writeSVG;
+		Coord min;
+		Coord max;
+};
+
+#endif /*FRAME_EXPORTER_H_*/
@@ -26,6 +26,7 @@
 #include "Model.h"
 #include "Component.h"
 #include "Link.h"
+#include "TimingStats.h"
 
 #include "GLCanvas.h"
 
@@ -40,6 +41,8 @@ EVT_ERASE_BACKGROUND(GLCanvas::OnEraseBackground)
 END_EVENT_TABLE()
 
 const double GLCanvas::defaultScale = 5.5;
+const double GLCanvas::minTextPixels = 5.0;
+const double GLCanvas::minCurveScale = 1.5;
 
 
 GLCanvas::GLCanvas(Model* proc, wxWindow* parent, Frame* frame, wxWindowID id, const wxPoint& pos, 
@@ -50,6 +53,7 @@ GLCanvas::GLCanvas(Model* proc, wxWindow* parent, Frame* frame, wxWindowID id, c
 {
 	this->frame = frame;
 	init = false;
+	geometryValid = false;
 	processor = proc;
 	scale = defaultScale;
 	currPos = wxPoint();
@@ -59,6 +63,12 @@ GLCanvas::GLCanvas(Model* proc, wxWindow* parent, Frame* frame, wxWindowID id, c
 }
 
 void GLCanvas::Render()
+{
+	geometryValid = false;
+	Paint();
+}
+
+void GLCanvas::Paint()
 {
 	if (!IsShownOnScreen())
 	{
@@ -66,6 +76,8 @@ void GLCanvas::Render()
 		return;
 	}
 
+	TimingStats* timings = processor->getTimingStats();
+	ScopedTiming timing(timings, TIMING_PAINT);
 	SetCurrent(glContext);
 	if (!init) {
 		InitGL();
@@ -90,16 +102,85 @@ void GLCanvas::Render()
 
 	glClear(GL_COLOR_BUFFER_BIT);
 	
-	processor->draw(GetMousePosition(), scale / defaultScale);
+	// Panning and zooming only change the transform above, so the model is
+	// walked again only after it has changed.
+	if (!geometryValid)
+	{
+		ScopedTiming drawTiming(timings, TIMING_DRAW);
+		geometry.clear();
+		processor->draw(geometry, GetMousePosition(), scale / defaultScale);
+		geometryValid = true;
+	}
+	renderer.drawCache(geometry, scale / defaultScale);
+	if (timings)
+	{
+		DrawTimings(*timings);
+	}
 
 	glFlush();
   	SwapBuffers();
 }
 
+void GLCanvas::DrawTimings(TimingStats& stats)
+{
+	// Drawn in window pixels in the top left corner, over a pale box so it
+	// can be read over the datapath.
+	const auto size{ GetSize() };
+	const double lineHeight = GLRenderer::TEXT_PIXELS * 1.25;
+	const double width = GLRenderer::TEXT_PIXELS * 21;
+	const double height = lineHeight * (TIMING_MAX + 1);
+	renderer.pushState();
+	glLoadIdentity();
+	renderer.setColour(Color(1.0, 1.0, 1.0, 0.8));
+	renderer.begin(PRIMITIVE_TRIANGLE_STRIP);
+	renderer.vertex(0, size.y);
+	renderer.vertex(width, size.y);
+	renderer.vertex(0, size.y - height);
+	renderer.vertex(width, size.y - height);
+	renderer.end();
+	// The font is proportional, so each column is drawn on its own.
+	const double columns[3] = { 4, GLRenderer::TEXT_PIXELS * 9, GLRenderer::TEXT_PIXELS * 15 };
+	renderer.setColour(Color(0.0, 0.0, 0.0, 1.0));
+	double y = size.y - lineHeight;
+	renderer.drawText(columns[0], y, _T("Timing (ms)"), 1.0);
+	renderer.drawText(columns[1], y, _T("Average"), 1.0);
+	renderer.drawText(columns[2], y, _T("Maximum"), 1.0);
+	for (int i = 0; i < TIMING_MAX; i++)
+	{
+		TimingName name = (TimingName)i;
+		y -= lineHeight;
+		renderer.drawText(columns[0], y, wxString::FromAscii(TimingStats::getName(name)), 1.0);
+		renderer.drawText(columns[1], y, wxString::Format(_T("%.3f"), stats.getAverage(name)), 1.0);
+		renderer.drawText(columns[2], y, wxString::Format(_T("%.3f"), stats.getMaximum(name)), 1.0);
+	}
+	renderer.popState();
+}
+
 void GLCanvas::SetZoom(int zoom)
 {
 	scale = defaultScale * std::pow(0.98, static_cast<double>(zoom));
-	Render();
+	UpdateDetailLevel();
+	Paint();
+}
+
+void GLCanvas::UpdateDetailLevel()
+{
+	DetailLevel level = DETAIL_FULL;
+	if (scale < minCurveScale)
+	{
+		level = DETAIL_OUTLINE;
+	}
+	else if (GLRenderer::TEXT_PIXELS * scale / defaultScale < minTextPixels)
+	{
+		level = DETAIL_NO_TEXT;
+	}
+	// The recorded geometry only needs redoing when the level changes, so
+	// zooming within a level still just replays it.
+	if (level != processor->getDetailLevel())
+	{
+		processor->setDetailLevel(level);
+		geometryValid = false;
+	}
 }
 
 wxSize GLCanvas::GetCanvasSize()
@@ -123,7 +204,7 @@ void GLCanvas::InitGL()
 void GLCanvas::OnPaint(wxPaintEvent& event)
 {		
 	wxPaintDC dc(this); // required for correct refreshing under MS windows
-	Render();
+	Paint();
 }
 
 wxPoint GLCanvas::GetMousePosition() const
@@ -161,20 +242,22 @@ void GLCanvas::OnLeftClick(wxMouseEvent& event)
 	const wxPoint mousePos{ event.GetPosition() };
 	if (downPos == mousePos)
 	{
+		frame->stopRun();
 		processor->step();
-		frame->updateDataList();
+		frame->updateDataListAfterStep();
+		Render();
 	}
 	else
 	{
 		offset += mousePos - currPos;
+		Paint();
 	}
- 	Render();
 }
 
 void GLCanvas::OnRightClick(wxMouseEvent& event)
 {
 	frame->showHideLeftPanel(true, true);
-	Render();
+	Paint();
 }
 
 void GLCanvas::OnMouseMotion(wxMouseEvent& event)
@@ -184,20 +267,20 @@ void GLCanvas::OnMouseMotion(wxMouseEvent& event)
 		const wxPoint mousePos{ event.GetPosition() };
 		offset += mousePos - currPos;
 		currPos = mousePos;
-		Render();
+		Paint();
 	}
 
 	popUpString.Clear();
-	if(Model::getBool(SHOW_POPUPS))
+	if(processor->getBool(SHOW_POPUPS))
 	{
 		// Display popup if the mouse is over a component.
 		// Set bounding rectangle to hide popup once the mouse leave the bounds of that component.
 		Component *comp = processor->findComponent(GetMousePosition());
 		// Find link if no component found.
 		Link *ln = (comp == 0) ? processor->findLink(GetMousePosition()) : 0;
-		if(Model::getBool(SHOW_CONTROL_LINES) || !(((comp == 0) ? false : comp->getIsControl()) || ((ln == 0) ? false : ln->getIsControl())))
+		if(processor->getBool(SHOW_CONTROL_LINES) || !(((comp == 0) ? false : comp->getIsControl()) || ((ln == 0) ? false : ln->getIsControl())))
 		{
-			if(Model::getBool(SHOW_PC_LINES) || !(((comp == 0) ? false : comp->getIsPC()) || ((ln == 0) ? false : ln->getIsPC())))
+			if(processor->getBool(SHOW_PC_LINES) || !(((comp == 0) ? false : comp->getIsPC()) || ((ln == 0) ? false : ln->getIsPC())))
 			{
 				if(ln != 0 && comp == 0 && ln != prevTipLink)
 				{
@@ -314,7 +397,8 @@ void GLCanvas::OnMouseMotion(wxMouseEvent& event)
 void GLCanvas::OnWheel(wxMouseEvent& event)
 {
 	scale *= std::pow(0.98, static_cast<double>(-event.GetWheelRotation()) * 4 / event.GetWheelDelta());
-	Render();
+	UpdateDetailLevel();
+	Paint();
 }
 
 void GLCanvas::OnEraseBackground(wxEraseEvent &event)
@@ -32,11 +32,14 @@
 #include <wx/tipwin.h>
 
 #include "Enums.h"
+#include "GLRenderer.h"
+#include "GeometryCache.h"
 
 class Frame;
 class Model;
 class Component;
 class Link;
+class TimingStats;
 
 class GLCanvas : public wxGLCanvas
 {
@@ -52,12 +55,16 @@ public:
 		int* attribList = 0,
 		const wxPalette& palette = wxNullPalette);
 	// constructor
+	// Redraw after the model has changed.
 	void Render();
 	void SetZoom(int zoom);
 	wxSize GetCanvasSize();
 	double GetScale() { return scale; }
 private:
 	void InitGL();                     // function to initialise GL context
+	void Paint();                      // redraw, reusing the recorded geometry if still valid
+	void UpdateDetailLevel();          // pick the detail level for the current scale
+	void DrawTimings(TimingStats& stats); // overlay the rolling step and redraw timings
 	void OnPaint(wxPaintEvent& event); // callback for when canvas is exposed
 	void OnLeftDown(wxMouseEvent& event);
 	void OnLeftClick(wxMouseEvent& event);
@@ -71,6 +78,8 @@ private:
 	bool init;
 	Model *processor;
 	static const double defaultScale;
+	static const double minTextPixels;  // smallest line height still drawn
+	static const double minCurveScale;  // scale below which curves are drawn as boxes
 	double scale;
 	wxPoint offset;
 	wxPoint currPos;
@@ -81,6 +90,9 @@ private:
 	Link* prevTipLink;
 	Frame* frame;
 	wxGLContext glContext;
+	GLRenderer renderer;
+	GeometryCache geometry;
+	bool geometryValid;
 
 	DECLARE_EVENT_TABLE()
 };
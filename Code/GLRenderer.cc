@@ -0,0 +1,227 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <cmath>
+
+#include <wx/glcanvas.h>
+
+#include "Types.h"
+
+#include "GeometryCache.h"
+#include "GLRenderer.h"
+
+const float GLRenderer::TEXT_PIXELS = 13.0;
+
+GLRenderer::GLRenderer()
+{
+	displayList = 0;
+	compiledCache = 0;
+	compiledVersion = 0;
+	compiledTextSize = 0;
+}
+
+void GLRenderer::pushState()
+{
+	glPushAttrib(GL_CURRENT_BIT | GL_ENABLE_BIT | GL_LINE_BIT | GL_COLOR_BUFFER_BIT);
+	glPushMatrix();
+}
+
+void GLRenderer::popState()
+{
+	glPopMatrix();
+	glPopAttrib();
+}
+
+void GLRenderer::translate(double x, double y)
+{
+	glTranslatef(x, y, 0.0);
+}
+
+void GLRenderer::scale(double x, double y)
+{
+	glScalef(x, y, 1.0);
+}
+
+void GLRenderer::rotate(double degrees)
+{
+	glRotatef(degrees, 0, 0, 1);
+}
+
+void GLRenderer::setColour(const Color& colour)
+{
+	glColor4fv(colour.c);
+}
+
+void GLRenderer::setLineWidth(float width)
+{
+	glLineWidth(width);
+}
+
+void GLRenderer::setPolygonSmooth(bool smooth)
+{
+	if(smooth)
+	{
+		glEnable(GL_POLYGON_SMOOTH);
+	}
+	else
+	{
+		glDisable(GL_POLYGON_SMOOTH);
+	}
+}
+
+void GLRenderer::begin(PrimitiveType type)
+{
+	switch(type)
+	{
+		case PRIMITIVE_TRIANGLES:
+			glBegin(GL_TRIANGLES);
+			break;
+		case PRIMITIVE_TRIANGLE_STRIP:
+			glBegin(GL_TRIANGLE_STRIP);
+			break;
+		case PRIMITIVE_POLYGON:
+			glBegin(GL_POLYGON);
+			break;
+		case PRIMITIVE_LINE_STRIP:
+			glBegin(GL_LINE_STRIP);
+			break;
+		case PRIMITIVE_LINE_LOOP:
+			glBegin(GL_LINE_LOOP);
+			break;
+	}
+}
+
+void GLRenderer::vertex(double x, double y)
+{
+	glVertex2f(x, y);
+}
+
+void GLRenderer::end()
+{
+	glEnd();
+}
+
+void GLRenderer::drawText(double x, double y, const wxString& text, double zoom)
+{
+	// Draw in window pixels from the transformed origin, so the text is not
+	// stretched by any scale the caller has applied.
+	GLfloat m[16];
+	GLfloat colour[4];
+	glGetFloatv(GL_MODELVIEW_MATRIX, m);
+	glGetFloatv(GL_CURRENT_COLOR, colour);
+	float ex = m[0] * x + m[4] * y + m[12];
+	float ey = m[1] * x + m[5] * y + m[13];
+	std::vector<float> positions, texCoords, colours;
+	atlas.load();
+	atlas.addText(ex, ey, TEXT_PIXELS * zoom, text, Color(colour[0], colour[1], colour[2], colour[3]), positions, texCoords, colours);
+	glPushMatrix();
+	glLoadIdentity();
+	drawGlyphs(positions, texCoords, colours);
+	glPopMatrix();
+}
+
+void GLRenderer::drawCache(const GeometryCache& cache, double zoom)
+{
+	// Text keeps the same size on screen as drawText() would give it, which in
+	// model units only changes if the view's scale does not follow the zoom.
+	GLfloat m[16];
+	glGetFloatv(GL_MODELVIEW_MATRIX, m);
+	float textSize = TEXT_PIXELS * zoom / std::sqrt(m[0] * m[0] + m[1] * m[1]);
+	if(displayList != 0 && compiledCache == &cache && compiledVersion == cache.getVersion()
+		&& std::fabs(textSize - compiledTextSize) <= compiledTextSize * 1e-3)
+	{
+		glCallList(displayList);
+		return;
+	}
+	if(displayList == 0)
+	{
+		displayList = glGenLists(1);
+	}
+	atlas.load();
+	compiledCache = &cache;
+	compiledVersion = cache.getVersion();
+	compiledTextSize = textSize;
+
+	// Client array state is not compiled into the list, but the array contents
+	// referenced by glDrawArrays are copied into it.
+	glNewList(displayList, GL_COMPILE);
+	glPushAttrib(GL_CURRENT_BIT | GL_ENABLE_BIT | GL_LINE_BIT);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, cache.getPositions().data());
+	glColorPointer(4, GL_FLOAT, 0, cache.getColours().data());
+	for(auto&& batch : cache.getBatches())
+	{
+		if(batch.count == 0)
+		{
+			continue;
+		}
+		switch(batch.mode)
+		{
+			case GEOMETRY_TRIANGLES:
+			case GEOMETRY_POLYGON:
+				setPolygonSmooth(batch.smooth);
+				glDrawArrays((batch.mode == GEOMETRY_TRIANGLES) ? GL_TRIANGLES : GL_POLYGON, batch.first, batch.count);
+				break;
+			case GEOMETRY_LINES:
+				glLineWidth(batch.lineWidth);
+				glDrawArrays(GL_LINES, batch.first, batch.count);
+				break;
+		}
+	}
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	// Every label in the frame goes in one draw.
+	std::vector<float> positions, texCoords, colours;
+	for(auto&& text : cache.getTexts())
+	{
+		atlas.addText(text.x, text.y, textSize, text.text, text.colour, positions, texCoords, colours);
+	}
+	drawGlyphs(positions, texCoords, colours);
+	glPopAttrib();
+	glEndList();
+
+	glCallList(displayList);
+}
+
+void GLRenderer::drawGlyphs(const std::vector<float>& positions, const std::vector<float>& texCoords, const std::vector<float>& colours)
+{
+	if(positions.empty())
+	{
+		return;
+	}
+	glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT);
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, atlas.getTexture());
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, positions.data());
+	glTexCoordPointer(2, GL_FLOAT, 0, texCoords.data());
+	glColorPointer(4, GL_FLOAT, 0, colours.data());
+	glDrawArrays(GL_QUADS, 0, positions.size() / 2);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glPopAttrib();
+}
@@ -0,0 +1,65 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef GL_RENDERER_H_
+#define GL_RENDERER_H_
+
+#include <vector>
+
+#include "Types.h"
+#include "Renderer.h"
+#include "GlyphAtlas.h"
+
+class GeometryCache;
+
+// Immediate mode OpenGL implementation of Renderer. Requires a current GL
+// context for the duration of the draw.
+class GLRenderer : public Renderer
+{
+	public:
+		GLRenderer();
+		virtual void pushState();
+		virtual void popState();
+		virtual void translate(double x, double y);
+		virtual void scale(double x, double y);
+		virtual void rotate(double degrees);
+		virtual void setColour(const Color& colour);
+		virtual void setLineWidth(float width);
+		virtual void setPolygonSmooth(bool smooth);
+		virtual void begin(PrimitiveType type);
+		virtual void vertex(double x, double y);
+		virtual void end();
+		virtual void drawText(double x, double y, const wxString& text, double zoom);
+		// Draw a recorded frame. It is compiled into a display list the first
+		// time, and again only when the cache or the text size changes.
+		void drawCache(const GeometryCache& cache, double zoom);
+		static const float TEXT_PIXELS; // Line height at a zoom of 1.
+	private:
+		void drawGlyphs(const std::vector<float>& positions, const std::vector<float>& texCoords, const std::vector<float>& colours);
+		GlyphAtlas atlas;
+		uint displayList;
+		const GeometryCache* compiledCache;
+		uint compiledVersion;
+		float compiledTextSize;
+};
+
+#endif /*GL_RENDERER_H_*/
@@ -0,0 +1,300 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "GeometryCache.h"
+
+const double GeometryCache::PI = 3.14159265358979323;
+
+GeometryCache::GeometryCache()
+{
+	version = 0;
+	clear();
+}
+
+void GeometryCache::clear()
+{
+	// Same initial state as a fresh GL context.
+	const double identity[6] = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+	std::copy(identity, identity + 6, state.m);
+	state.colour = Color(1.0, 1.0, 1.0, 1.0);
+	state.lineWidth = 1.0;
+	state.smooth = false;
+	stack.clear();
+	primitive.clear();
+	batches.clear();
+	positions.clear();
+	colours.clear();
+	texts.clear();
+	++version;
+}
+
+void GeometryCache::pushState()
+{
+	stack.push_back(state);
+}
+
+void GeometryCache::popState()
+{
+	if(!stack.empty())
+	{
+		state = stack.back();
+		stack.pop_back();
+	}
+}
+
+void GeometryCache::translate(double x, double y)
+{
+	double* m = state.m;
+	m[4] += m[0] * x + m[2] * y;
+	m[5] += m[1] * x + m[3] * y;
+}
+
+void GeometryCache::scale(double x, double y)
+{
+	double* m = state.m;
+	m[0] *= x;
+	m[1] *= x;
+	m[2] *= y;
+	m[3] *= y;
+}
+
+void GeometryCache::rotate(double degrees)
+{
+	double* m = state.m;
+	double rad = degrees * PI / 180.0;
+	double c = std::cos(rad);
+	double s = std::sin(rad);
+	double m0 = m[0], m1 = m[1];
+	m[0] = m0 * c + m[2] * s;
+	m[1] = m1 * c + m[3] * s;
+	m[2] = m[2] * c - m0 * s;
+	m[3] = m[3] * c - m1 * s;
+}
+
+void GeometryCache::setColour(const Color& colour)
+{
+	state.colour = colour;
+}
+
+void GeometryCache::setLineWidth(float width)
+{
+	state.lineWidth = width;
+}
+
+void GeometryCache::setPolygonSmooth(bool smooth)
+{
+	state.smooth = smooth;
+}
+
+void GeometryCache::begin(PrimitiveType type)
+{
+	primitiveType = type;
+	primitive.clear();
+}
+
+void GeometryCache::vertex(double x, double y)
+{
+	const double* m = state.m;
+	Vertex v;
+	v.x = (float)(m[0] * x + m[2] * y + m[4]);
+	v.y = (float)(m[1] * x + m[3] * y + m[5]);
+	v.colour = state.colour;
+	primitive.push_back(v);
+}
+
+void GeometryCache::end()
+{
+	uint n = primitive.size();
+	switch(primitiveType)
+	{
+		case PRIMITIVE_TRIANGLES:
+			getBatch(GEOMETRY_TRIANGLES);
+			for(uint i = 0; i + 2 < n; i += 3)
+			{
+				addVertex(primitive[i]);
+				addVertex(primitive[i + 1]);
+				addVertex(primitive[i + 2]);
+			}
+			break;
+		case PRIMITIVE_TRIANGLE_STRIP:
+			getBatch(GEOMETRY_TRIANGLES);
+			for(uint i = 2; i < n; ++i)
+			{
+				// Keep the winding of every other triangle the same as GL would.
+				addVertex(primitive[(i % 2) ? i - 1 : i - 2]);
+				addVertex(primitive[(i % 2) ? i - 2 : i - 1]);
+				addVertex(primitive[i]);
+			}
+			break;
+		case PRIMITIVE_POLYGON:
+			if(state.smooth)
+			{
+				// A fan would show the inner edges once they are antialiased.
+				getBatch(GEOMETRY_POLYGON);
+				for(auto&& v : primitive)
+				{
+					addVertex(v);
+				}
+			}
+			else
+			{
+				getBatch(GEOMETRY_TRIANGLES);
+				for(uint i = 2; i < n; ++i)
+				{
+					addVertex(primitive[0]);
+					addVertex(primitive[i - 1]);
+					addVertex(primitive[i]);
+				}
+			}
+			break;
+		case PRIMITIVE_LINE_STRIP:
+		case PRIMITIVE_LINE_LOOP:
+			getBatch(GEOMETRY_LINES);
+			for(uint i = 1; i < n; ++i)
+			{
+				addVertex(primitive[i - 1]);
+				addVertex(primitive[i]);
+			}
+			if(primitiveType == PRIMITIVE_LINE_LOOP && n > 2)
+			{
+				addVertex(primitive[n - 1]);
+				addVertex(primitive[0]);
+			}
+			break;
+	}
+	primitive.clear();
+}
+
+void GeometryCache::drawText(double x, double y, const wxString& text, double WXUNUSED(zoom))
+{
+	// Text is sized when the cache is drawn, so only its position is kept.
+	const double* m = state.m;
+	GeometryText t;
+	t.x = (float)(m[0] * x + m[2] * y + m[4]);
+	t.y = (float)(m[1] * x + m[3] * y + m[5]);
+	t.colour = state.colour;
+	t.text = text;
+	texts.push_back(t);
+}
+
+GeometryBatch& GeometryCache::getBatch(GeometryMode mode)
+{
+	if(!batches.empty() && mode != GEOMETRY_POLYGON)
+	{
+		// Line width only matters to lines and smoothing only to triangles.
+		GeometryBatch& last = batches.back();
+		if(last.mode == mode
+			&& (mode != GEOMETRY_LINES || last.lineWidth == state.lineWidth)
+			&& (mode != GEOMETRY_TRIANGLES || last.smooth == state.smooth))
+		{
+			return last;
+		}
+	}
+	GeometryBatch batch;
+	batch.mode = mode;
+	batch.lineWidth = state.lineWidth;
+	batch.smooth = state.smooth;
+	batch.first = positions.size() / 2;
+	batch.count = 0;
+	batches.push_back(batch);
+	return batches.back();
+}
+
+void GeometryCache::addVertex(const Vertex& v)
+{
+	positions.push_back(v.x);
+	positions.push_back(v.y);
+	colours.insert(colours.end(), v.colour.c, v.colour.c + 4);
+	batches.back().count++;
+}
+
+void GeometryCache::writeSVG(std::ostream& out, Coord min, Coord max, double scale, double textSize) const
+{
+	// SVG has y pointing down, the layout has it pointing up.
+	auto x = [&](uint v){ return positions[2 * v] - min.x; };
+	auto y = [&](uint v){ return max.y - positions[2 * v + 1]; };
+	double width = max.x - min.x;
+	double height = max.y - min.y;
+	out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width * scale << "\" height=\"" << height * scale
+		<< "\" viewBox=\"0 0 " << width << " " << height << "\">\n";
+	for(auto&& batch : batches)
+	{
+		// One path per run of vertices with the same colour.
+		uint step = (batch.mode == GEOMETRY_TRIANGLES) ? 3 : (batch.mode == GEOMETRY_LINES) ? 2 : batch.count;
+		uint end = batch.first + batch.count;
+		uint v = batch.first;
+		while(step != 0 && v + step <= end)
+		{
+			const float* colour = &colours[4 * v];
+			out << "<path d=\"";
+			do
+			{
+				out << "M" << x(v) << " " << y(v);
+				for(uint i = 1; i < step; ++i)
+				{
+					out << " L" << x(v + i) << " " << y(v + i);
+				}
+				out << ((batch.mode == GEOMETRY_LINES) ? " " : " Z ");
+				v += step;
+			}
+			while(v + step <= end && std::memcmp(colour, &colours[4 * v], 4 * sizeof(float)) == 0);
+			out << "\"";
+			if(batch.mode == GEOMETRY_LINES)
+			{
+				out << " fill=\"none\" stroke-width=\"" << batch.lineWidth / scale << "\"";
+				writeSVGColour(out, "stroke", colour);
+			}
+			else
+			{
+				writeSVGColour(out, "fill", colour);
+			}
+			out << "/>\n";
+		}
+	}
+	for(auto&& text : texts)
+	{
+		out << "<text x=\"" << text.x - min.x << "\" y=\"" << max.y - text.y
+			<< "\" font-family=\"Helvetica, Arial, sans-serif\" font-size=\"" << textSize << "\"";
+		writeSVGColour(out, "fill", text.colour.c);
+		out << ">";
+		wxString escaped = text.text;
+		escaped.Replace(_T("&"), _T("&amp;"));
+		escaped.Replace(_T("<"), _T("&lt;"));
+		escaped.Replace(_T(">"), _T("&gt;"));
+		out << (const char*)escaped.mb_str() << "</text>\n";
+	}
+	out << "</svg>\n";
+}
+
+void GeometryCache::writeSVGColour(std::ostream& out, const char* attribute, const float* colour)
+{
+	out << " " << attribute << "=\"rgb(" << (int)(colour[0] * 255 + 0.5) << "," << (int)(colour[1] * 255 + 0.5) << "," << (int)(colour[2] * 255 + 0.5) << ")\"";
+	if(colour[3] < 1.0)
+	{
+		out << " " << attribute << "-opacity=\"" << colour[3] << "\"";
+	}
+}
@@ -0,0 +1,125 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef GEOMETRY_CACHE_H_
+#define GEOMETRY_CACHE_H_
+
+#include <ostream>
+#include <vector>
+
+#include <wx/string.h>
+
+#include "Types.h"
+#include "Coord.h"
+#include "Renderer.h"
+
+enum GeometryMode
+{
+	GEOMETRY_TRIANGLES,
+	GEOMETRY_LINES,
+	GEOMETRY_POLYGON
+};
+
+// A run of vertices drawn with the same state.
+struct GeometryBatch
+{
+	GeometryMode mode;
+	float lineWidth;
+	bool smooth;
+	uint first;
+	uint count;
+};
+
+struct GeometryText
+{
+	float x;
+	float y;
+	Color colour;
+	wxString text;
+};
+
+// Renderer that records a frame instead of drawing it. Transforms are applied
+// as the vertices arrive, and primitives are converted to triangles and line
+// segments so that consecutive primitives with the same state share a batch.
+// Text is kept separately and is drawn on top of all the geometry.
+// The result can be drawn again by a renderer without walking the model.
+class GeometryCache : public Renderer
+{
+	public:
+		GeometryCache();
+		void clear();
+		// Incremented by clear(), so a replaying renderer can tell it has changed.
+		uint getVersion() const { return version; };
+		const std::vector<GeometryBatch>& getBatches() const { return batches; };
+		// Two floats (x, y) per vertex.
+		const std::vector<float>& getPositions() const { return positions; };
+		// Four floats (r, g, b, a) per vertex.
+		const std::vector<float>& getColours() const { return colours; };
+		const std::vector<GeometryText>& getTexts() const { return texts; };
+		// Write the area between min and max as an SVG document. scale is the
+		// size in pixels of one layout unit, which sets the image size and
+		// turns line widths (in pixels) into layout units. textSize is the
+		// line height of text in layout units.
+		void writeSVG(std::ostream& out, Coord min, Coord max, double scale, double textSize) const;
+		virtual void pushState();
+		virtual void popState();
+		virtual void translate(double x, double y);
+		virtual void scale(double x, double y);
+		virtual void rotate(double degrees);
+		virtual void setColour(const Color& colour);
+		virtual void setLineWidth(float width);
+		virtual void setPolygonSmooth(bool smooth);
+		virtual void begin(PrimitiveType type);
+		virtual void vertex(double x, double y);
+		virtual void end();
+		// zoom is ignored; the replaying renderer chooses the font.
+		virtual void drawText(double x, double y, const wxString& text, double zoom);
+	private:
+		struct State
+		{
+			double m[6]; // x' = m0 x + m2 y + m4, y' = m1 x + m3 y + m5
+			Color colour;
+			float lineWidth;
+			bool smooth;
+		};
+		struct Vertex
+		{
+			float x;
+			float y;
+			Color colour;
+		};
+		static const double PI;
+		GeometryBatch& getBatch(GeometryMode mode);
+		static void writeSVGColour(std::ostream& out, const char* attribute, const float* colour);
+		void addVertex(const Vertex& v);
+		State state;
+		std::vector<State> stack;
+		PrimitiveType primitiveType;
+		std::vector<Vertex> primitive; // Vertices since begin().
+		std::vector<GeometryBatch> batches;
+		std::vector<float> positions;
+		std::vector<float> colours;
+		std::vector<GeometryText> texts;
+		uint version;
+};
+
+#endif /*GEOMETRY_CACHE_H_*/
@@ -0,0 +1,148 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <algorithm>
+
+#include <wx/dcmemory.h>
+#include <wx/image.h>
+#include <wx/glcanvas.h>
+
+#include "GlyphAtlas.h"
+
+GlyphAtlas::GlyphAtlas()
+{
+	lineHeight = 1.0;
+	descent = 0.0;
+	texture = 0;
+	loaded = false;
+}
+
+void GlyphAtlas::load()
+{
+	if(loaded)
+	{
+		return;
+	}
+	loaded = true;
+
+	wxBitmap bitmap(TEXTURE_WIDTH, TEXTURE_HEIGHT, 24);
+	wxMemoryDC dc(bitmap);
+	dc.SetBackground(*wxBLACK_BRUSH);
+	dc.Clear();
+	dc.SetFont(wxFont(wxSize(0, FONT_PIXELS), wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+	dc.SetTextForeground(*wxWHITE);
+	dc.SetBackgroundMode(wxTRANSPARENT);
+	wxCoord w, h, d;
+	dc.GetTextExtent(_T("Xg"), &w, &h, &d);
+	lineHeight = std::min(h, (wxCoord)CELL_SIZE);
+	descent = d;
+	for(int i = 0; i < NUM_GLYPHS; ++i)
+	{
+		wxString ch((wxChar)(FIRST_CHAR + i));
+		dc.GetTextExtent(ch, &w, &h);
+		int x = (i % COLUMNS) * CELL_SIZE;
+		int y = (i / COLUMNS) * CELL_SIZE;
+		dc.DrawText(ch, x, y);
+		Glyph& g = glyphs[i];
+		g.width = w;
+		g.u0 = (float)x / TEXTURE_WIDTH;
+		g.u1 = (float)(x + std::min(w, (wxCoord)CELL_SIZE)) / TEXTURE_WIDTH;
+		g.v0 = (float)y / TEXTURE_HEIGHT;
+		g.v1 = (float)(y + lineHeight) / TEXTURE_HEIGHT;
+	}
+	dc.SelectObject(wxNullBitmap);
+
+	// White on black, so any channel will do for the coverage.
+	wxImage image = bitmap.ConvertToImage();
+	const unsigned char* rgb = image.GetData();
+	std::vector<unsigned char> alpha(TEXTURE_WIDTH * TEXTURE_HEIGHT);
+	for(uint i = 0; i < alpha.size(); ++i)
+	{
+		alpha[i] = rgb[3 * i];
+	}
+
+	GLuint name;
+	glGenTextures(1, &name);
+	texture = name;
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, TEXTURE_WIDTH, TEXTURE_HEIGHT, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &alpha[0]);
+}
+
+void GlyphAtlas::addText(float x, float y, float size, const wxString& text, const Color& colour,
+	std::vector<float>& positions, std::vector<float>& texCoords, std::vector<float>& colours)
+{
+	load();
+	float k = size / lineHeight;
+	float y0 = y - descent * k;
+	float y1 = y0 + lineHeight * k;
+	for(auto&& placed : getLayout(text))
+	{
+		const Glyph& g = glyphs[placed.glyph];
+		float x0 = x + placed.x * k;
+		float x1 = x0 + std::min(g.width, (float)CELL_SIZE) * k;
+		const float quad[8] = {x0, y0, x1, y0, x1, y1, x0, y1};
+		const float uv[8] = {g.u0, g.v1, g.u1, g.v1, g.u1, g.v0, g.u0, g.v0};
+		positions.insert(positions.end(), quad, quad + 8);
+		texCoords.insert(texCoords.end(), uv, uv + 8);
+		for(int i = 0; i < 4; ++i)
+		{
+			colours.insert(colours.end(), colour.c, colour.c + 4);
+		}
+	}
+}
+
+const std::vector<GlyphAtlas::PlacedGlyph>& GlyphAtlas::getLayout(const wxString& text)
+{
+	auto found = layouts.find(text);
+	if(found != layouts.end())
+	{
+		return found->second;
+	}
+	if(layouts.size() >= MAX_LAYOUTS)
+	{
+		layouts.clear();
+	}
+	std::vector<PlacedGlyph>& layout = layouts[text];
+	float pen = 0;
+	for(uint i = 0; i < text.length(); ++i)
+	{
+		int c = text[i];
+		if(c < FIRST_CHAR || c >= FIRST_CHAR + NUM_GLYPHS)
+		{
+			c = '?';
+		}
+		PlacedGlyph placed;
+		placed.x = pen;
+		placed.glyph = c - FIRST_CHAR;
+		pen += glyphs[placed.glyph].width;
+		if(c != ' ')
+		{
+			layout.push_back(placed);
+		}
+	}
+	return layout;
+}
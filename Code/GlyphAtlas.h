@@ -0,0 +1,77 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef GLYPH_ATLAS_H_
+#define GLYPH_ATLAS_H_
+
+#include <map>
+#include <vector>
+
+#include <wx/string.h>
+
+#include "Types.h"
+#include "Color.h"
+
+// Printable ASCII rendered once into an alpha texture, so that text can be
+// drawn as textured quads instead of one bitmap call per character.
+class GlyphAtlas
+{
+	public:
+		GlyphAtlas();
+		// Create the texture if needed. Requires a current GL context, and must
+		// not be first called while a display list is being compiled.
+		void load();
+		uint getTexture(){ return texture; };
+		// Append a quad (four vertices) per character of text, with its
+		// baseline starting at (x, y) and a line height of size.
+		void addText(float x, float y, float size, const wxString& text, const Color& colour,
+			std::vector<float>& positions, std::vector<float>& texCoords, std::vector<float>& colours);
+	private:
+		struct Glyph
+		{
+			float u0, v0, u1, v1;
+			float width;
+		};
+		struct PlacedGlyph
+		{
+			float x;
+			uint glyph;
+		};
+		const std::vector<PlacedGlyph>& getLayout(const wxString& text);
+		static const int FONT_PIXELS = 24;
+		static const int CELL_SIZE = 32;
+		static const int COLUMNS = 16;
+		static const int TEXTURE_WIDTH = 512;
+		static const int TEXTURE_HEIGHT = 256;
+		static const int FIRST_CHAR = 32;
+		static const int NUM_GLYPHS = 95;
+		static const uint MAX_LAYOUTS = 1024;
+		Glyph glyphs[NUM_GLYPHS];
+		float lineHeight;
+		float descent;
+		uint texture;
+		bool loaded;
+		// Glyph positions for each string drawn, in atlas pixels.
+		std::map<wxString, std::vector<PlacedGlyph>> layouts;
+};
+
+#endif /*GLYPH_ATLAS_H_*/
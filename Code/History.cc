@@ -0,0 +1,112 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+ 
+#include "History.h"
+
+History::History()
+{
+	bytesUsed = 0;
+	maxBytes = DEFAULT_MAX_BYTES;
+}
+
+void History::record(const std::vector<luint>& before, const std::vector<luint>& after, const std::vector<MemoryWrite>& writes)
+{
+	if(maxBytes == 0)
+	{
+		return;
+	}
+	if(before.size() != after.size())
+	{
+		// The layout changed, older cycles can no longer be applied.
+		clear();
+		return;
+	}
+	Delta delta;
+	delta.numWords = 0;
+	for(uint i = 0; i < before.size(); i++)
+	{
+		if(before[i] != after[i])
+		{
+			words.push_back(std::make_pair(i, before[i]));
+			delta.numWords++;
+		}
+	}
+	this->writes.insert(this->writes.end(), writes.begin(), writes.end());
+	delta.numWrites = writes.size();
+	deltas.push_back(delta);
+	bytesUsed += getBytes(delta);
+	trim();
+}
+
+bool History::undo(std::vector<luint>& state, std::vector<MemoryWrite>& writes)
+{
+	if(deltas.empty())
+	{
+		return false;
+	}
+	Delta& delta = deltas.back();
+	for(uint i = 0; i < delta.numWords; i++)
+	{
+		if(words.back().first < state.size())
+		{
+			state[words.back().first] = words.back().second;
+		}
+		words.pop_back();
+	}
+	writes.assign(this->writes.end() - delta.numWrites, this->writes.end());
+	this->writes.erase(this->writes.end() - delta.numWrites, this->writes.end());
+	bytesUsed -= getBytes(delta);
+	deltas.pop_back();
+	return true;
+}
+
+void History::clear()
+{
+	deltas.clear();
+	words.clear();
+	writes.clear();
+	bytesUsed = 0;
+}
+
+void History::setMaxBytes(luint maxBytes)
+{
+	this->maxBytes = maxBytes;
+	trim();
+}
+
+void History::trim()
+{
+	while(!deltas.empty() && bytesUsed > maxBytes)
+	{
+		Delta& delta = deltas.front();
+		words.erase(words.begin(), words.begin() + delta.numWords);
+		writes.erase(writes.begin(), writes.begin() + delta.numWrites);
+		bytesUsed -= getBytes(delta);
+		deltas.pop_front();
+	}
+}
+
+luint History::getBytes(const Delta& delta)
+{
+	return sizeof(Delta) + delta.numWords * sizeof(words[0]) + delta.numWrites * sizeof(MemoryWrite);
+}
@@ -0,0 +1,75 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+ 
+#ifndef HISTORY_H_
+#define HISTORY_H_
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "Types.h"
+#include "MemoryStore.h"
+
+// Bounded record of how each cycle changed the model, so cycles can be
+// undone without re-running the program from reset. A cycle is stored as
+// the state words it changed (see Model::saveState()) and the memory writes
+// it made, both with their previous values. The oldest cycles are dropped
+// once the memory used goes over the limit.
+class History
+{
+	public:
+		History();
+		void record(const std::vector<luint>& before, const std::vector<luint>& after, const std::vector<MemoryWrite>& writes);
+		// Undo the latest cycle. The changed words of state are set back and
+		// the memory writes to revert are returned, in the order they were made.
+		bool undo(std::vector<luint>& state, std::vector<MemoryWrite>& writes);
+		// Forget every cycle. The model does this whenever memory or the
+		// program is edited, as cycles before an edit can not be undone
+		// consistently.
+		void clear();
+		luint getNumCycles(){ return deltas.size(); };
+		luint getBytesUsed(){ return bytesUsed; };
+		luint getBytesPerCycle(){ return deltas.empty() ? 0 : bytesUsed / deltas.size(); };
+		luint getMaxBytes(){ return maxBytes; };
+		// A limit of 0 turns recording off.
+		void setMaxBytes(luint maxBytes);
+		static const luint DEFAULT_MAX_BYTES = 16<<20;
+	private:
+		// Changes of all cycles are kept end to end, each cycle knows how
+		// many entries at the back of words and writes belong to it.
+		struct Delta
+		{
+			uint numWords;
+			uint numWrites;
+		};
+		void trim();
+		luint getBytes(const Delta& delta);
+		std::deque<Delta> deltas;
+		std::deque<std::pair<uint, luint>> words; // State index and value before the cycle.
+		std::deque<MemoryWrite> writes;
+		luint bytesUsed;
+		luint maxBytes;
+};
+
+#endif /*HISTORY_H_*/
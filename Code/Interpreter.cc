@@ -0,0 +1,128 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+ 
+#include "Interpreter.h"
+
+Interpreter::Interpreter()
+{
+	registers.fill(0);
+	pc = 0;
+}
+
+void Interpreter::setInstruction(luint address, luint word)
+{
+	luint index = address / 4;
+	if(index >= program.size())
+	{
+		program.resize(index + 1);
+	}
+	Decoded& instr = program[index];
+	instr.op = (word>>26) & 0x3f;
+	instr.rs = (word>>21) & 0x1f;
+	instr.rt = (word>>16) & 0x1f;
+	instr.rd = (word>>11) & 0x1f;
+	instr.funct = word & 0x3f;
+	instr.imm = signExtend(word & 0xffff);
+}
+
+void Interpreter::setRegister(uint reg, luint val)
+{
+	// Register 0 is hard wired to zero, as in the Registers component.
+	if(reg != 0 && reg < NUM_REGISTERS)
+	{
+		registers[reg] = val & WORD_MASK;
+	}
+}
+
+luint Interpreter::signExtend(luint imm)
+{
+	return ((imm>>15) % 2) ? ((((luint)(1)<<16)-1)<<16) + imm : imm;
+}
+
+void Interpreter::step()
+{
+	// Addresses outside the program read as zero, which decodes to a noop.
+	static const Decoded noop;
+	luint index = pc / 4;
+	const Decoded& instr = (index < program.size()) ? program[index] : noop;
+	luint rs = registers[instr.rs];
+	luint rt = registers[instr.rt];
+	luint result;
+	luint nextPC = (pc + 4) & WORD_MASK;
+	switch(instr.op)
+	{
+		case 0: // R-Type.
+			switch(instr.funct)
+			{
+				case 32: // Add
+					result = (rs + rt) & WORD_MASK;
+					break;
+				case 34: // Sub
+					result = (rs - rt) & WORD_MASK;
+					break;
+				case 37: // Or
+					result = rs | rt;
+					break;
+				case 42: // Set on less than (signed).
+					result = ((int)(uint)rs < (int)(uint)rt) ? 1 : 0;
+					break;
+				default: // And, ALUControl also gives AND for unknown function codes.
+					result = rs & rt;
+					break;
+			}
+			setRegister(instr.rd, result);
+			break;
+		case 8: // Addi
+			setRegister(instr.rt, (rs + instr.imm) & WORD_MASK);
+			break;
+		case 35: // Lw
+		{
+			auto it = data.find((rs + instr.imm) & WORD_MASK);
+			setRegister(instr.rt, (it != data.end()) ? it->second : 0);
+			break;
+		}
+		case 43: // Sw
+			data[(rs + instr.imm) & WORD_MASK] = rt;
+			break;
+		case 4: // Beq
+			if(rs == rt)
+			{
+				nextPC = (nextPC + (instr.imm<<2)) & WORD_MASK;
+			}
+			break;
+		default: // Not produced by the Parser, treat as a noop.
+			break;
+	}
+	pc = nextPC;
+}
+
+luint Interpreter::run(luint count, luint stopAddress)
+{
+	luint executed = 0;
+	while(executed < count && pc != stopAddress)
+	{
+		step();
+		executed++;
+	}
+	return executed;
+}
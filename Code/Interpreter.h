@@ -0,0 +1,71 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+ 
+#ifndef INTERPRETER_H_
+#define INTERPRETER_H_
+
+#include <array>
+#include <map>
+#include <vector>
+
+#include "Types.h"
+
+// Instruction set level simulator. Executes the instruction words produced
+// by the Parser directly against a register file and data memory, with the
+// architectural behaviour of the single cycle layout. Used to fast forward a
+// program before handing its state over to the datapath components.
+class Interpreter
+{
+	public:
+		Interpreter();
+		void setInstruction(luint address, luint word);
+		void setRegister(uint reg, luint val);
+		luint getRegister(uint reg){ return registers[reg]; };
+		void setData(luint address, luint val){ data[address] = val; };
+		const std::map<luint, luint>& getData(){ return data; };
+		void setPC(luint address){ pc = address; };
+		luint getPC(){ return pc; };
+		// Execute the instruction at the PC.
+		void step();
+		// Execute up to count instructions, stopping early if the PC reaches
+		// stopAddress. Returns the number of instructions executed.
+		luint run(luint count, luint stopAddress = NO_STOP_ADDRESS);
+		static const uint NUM_REGISTERS = 32;
+		static const luint NO_STOP_ADDRESS = ((luint)1)<<32;
+	private:
+		// Instruction word split into its fields.
+		struct Decoded
+		{
+			Decoded() : op(0), rs(0), rt(0), rd(0), funct(0), imm(0){};
+			uint op, rs, rt, rd, funct;
+			luint imm;     // Sign extended immediate.
+		};
+		static luint signExtend(luint imm);
+		std::vector<Decoded> program;  // Indexed by word address.
+		std::array<luint, NUM_REGISTERS> registers;
+		std::map<luint, luint> data;
+		luint pc;
+		static const luint WORD_MASK = (((luint)1)<<32) - 1;
+};
+
+#endif /*INTERPRETER_H_*/
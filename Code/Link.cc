@@ -24,7 +24,6 @@
 
 #include "Link.h"
 
-int Link::count = 0;
 const int Link::LINK_WIDTH = 4;
 const int Link::LINK_HEIGHT_SHORT = 2;
 const int Link::LINK_HEIGHT_TALL = 4;
@@ -35,30 +34,19 @@ Link::Link(int slot, Component* comp, double x, double y, Side edge, bool output
 	this->pos.y = y;
 	this->textPos = Coord(textX, textY);
 	this->edge = edge;
-	ID = count;
-	count++;
+	ID = -1;
 	this->output = output;
 	this->control = control;
 	this->PC = PC;
 	this->comp = comp;
 	this->slot = slot;
-	this->value = 0;
+	this->ownValue = 0;
+	this->value = &ownValue;
 	this->showText = showText;
 	this->name = name;
 	active = false;
 	negBit16 = false;
-	instructionActive[SYM_BAD] = false; // So when no instr specified this test is effectively ignored.
-	instructionActive[SYM_ADD] = false;
-	instructionActive[SYM_ADDI] = false;
-	instructionActive[SYM_NOOP] = false;
-	instructionActive[SYM_LW] = false;
-	instructionActive[SYM_SW] = false;
-	instructionActive[SYM_AND] = false;
-	instructionActive[SYM_OR] = false;
-	instructionActive[SYM_SUB] = false;
-	instructionActive[SYM_SLT] = false;
-	instructionActive[SYM_BEQ] = false;
-	
+	instructionActive = 0; // SYM_BAD stays clear, so when no instr specified this test is effectively ignored.
 }
 
 InputLink::InputLink(int slot, Component* comp, double x, double y, Side edge, wxString name, bool control, bool PC, bool showText, uint startBit, uint bitLength, double textX, double textY)
@@ -170,14 +158,19 @@ bool InputLink::isActive()
 luint InputLink::getVal()
 {
 	// Get value from input.
-	return extractRequiredBits(value);
+	return extractRequiredBits(*value);
 }
 
 void InputLink::getValFromOutput()
 {
 	if(connected)
 	{
-		setVal(connectedOutput->getVal()); 
+		luint newValue = connectedOutput->getVal();
+		if(newValue != *value)
+		{
+			setVal(newValue);
+			getComp()->markDirty();
+		}
 	}
 }
 
@@ -199,7 +192,7 @@ luint OutputLink::getVal()
 	}
 	else
 	{
-		return value;
+		return *value;
 	}
 }
 
@@ -212,27 +205,22 @@ void Link::setInstrActivity(Symbol inst, bool active)
 {
 	if(inst == SYM_MAX)
 	{
-		instructionActive[SYM_ADD] = true;
-		instructionActive[SYM_ADDI] = true;
-		instructionActive[SYM_LW] = true;
-		instructionActive[SYM_SW] = true;
-		instructionActive[SYM_AND] = true;
-		instructionActive[SYM_OR] = true;
-		instructionActive[SYM_SUB] = true;
-		instructionActive[SYM_SLT] = true;
-		instructionActive[SYM_BEQ] = true;
+		// All instructions.
+		instructionActive |= symbolBit(SYM_ADD) | symbolBit(SYM_ADDI) | symbolBit(SYM_LW) | symbolBit(SYM_SW) | symbolBit(SYM_AND)
+			| symbolBit(SYM_OR) | symbolBit(SYM_SUB) | symbolBit(SYM_SLT) | symbolBit(SYM_BEQ);
 	}
 	else if(inst == SYM_EOF)
 	{
-		instructionActive[SYM_ADD] = true;
-		instructionActive[SYM_AND] = true;
-		instructionActive[SYM_OR] = true;
-		instructionActive[SYM_SUB] = true;
-		instructionActive[SYM_SLT] = true;
+		// R-Type instructions.
+		instructionActive |= symbolBit(SYM_ADD) | symbolBit(SYM_AND) | symbolBit(SYM_OR) | symbolBit(SYM_SUB) | symbolBit(SYM_SLT);
+	}
+	else if(active)
+	{
+		instructionActive |= symbolBit(inst);
 	}
 	else
 	{
-		instructionActive[inst] = active;
+		instructionActive &= ~symbolBit(inst);
 	}
 }
 
@@ -243,7 +231,7 @@ bool OutputLink::isActive()
 
 bool Link::isActiveValid(Symbol instr)
 {
-	return instructionActive[instr];
+	return (instructionActive & symbolBit(instr)) != 0;
 }
 
 void OutputLink::connect(Link* link)
@@ -45,6 +45,7 @@ class Link
 		Link(int slot, Component *comp, double x, double y, Side edge, bool output, bool control = false, bool PC = false, bool showText = false, wxString name = _T(""), double textX = 0, double textY = 0);
 		virtual ~Link(){};
 		int getID(){ return ID; };
+		void setID(int ID){ this->ID = ID; };
 		double getX(){ return pos.x; };
 		double getY(){ return pos.y; };
 		wxString getInfo();
@@ -65,7 +66,9 @@ class Link
 		int getAbsY();
 		virtual bool isActive() = 0;
 		bool isActiveValid(Symbol instr = SYM_BAD);
-		void setVal(luint value){ this->value = value; };
+		void setVal(luint value){ *(this->value) = value; };
+		// Move the value into external storage (used by Netlist).
+		void bindValue(luint* slot){ *slot = *value; value = slot; };
 		virtual luint getVal() = 0;
 		void setActive(bool active = true){ this->active = active; };
 		virtual void setBits(uint startBit, uint bitLength){};
@@ -79,9 +82,11 @@ class Link
 	protected:
 		bool active;
 		bool negBit16;
-		luint value; // Value in link.
-		std::map<Symbol, bool> instructionActive;
+		luint* value; // Value in link. Points at ownValue until bound to a netlist.
+		luint ownValue;
+		uint instructionActive; // Bit per Symbol, set if the link is used by that instruction.
 	private:
+		static uint symbolBit(Symbol instr){ return ((uint)1)<<instr; };
 		bool output;
 		bool showText;
 		bool control;
@@ -96,7 +101,6 @@ class Link
 		static const int LINK_WIDTH;
 		static const int LINK_HEIGHT_TALL;
 		static const int LINK_HEIGHT_SHORT;
-		static int count;
 		Component* comp;
 };
 
@@ -111,6 +115,8 @@ class InputLink: public Link
 		virtual bool isActive();
 		virtual luint getVal();
 		virtual void setBits(uint startBit,uint bitLength){ this->startBit = startBit; this->bitLength = bitLength; };
+		uint getStartBit(){ return startBit; };
+		uint getBitLength(){ return bitLength; };
 	private:
 		OutputLink* connectedOutput;
 		bool connected;
@@ -0,0 +1,149 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+MappedFile::MappedFile()
+{
+	data = 0;
+	size = 0;
+	opened = false;
+#ifdef _WIN32
+	file = INVALID_HANDLE_VALUE;
+	mapping = 0;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(wxString name)
+{
+	close();
+	file = CreateFile(name.fn_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize))
+	{
+		close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+	if(size != 0)
+	{
+		// Empty files can not be mapped.
+		mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		data = mapping ? (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+		if(data == 0)
+		{
+			close();
+			return false;
+		}
+	}
+	opened = true;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if(data != 0)
+	{
+		UnmapViewOfFile(data);
+	}
+	if(mapping != 0)
+	{
+		CloseHandle(mapping);
+	}
+	if(file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file);
+	}
+	file = INVALID_HANDLE_VALUE;
+	mapping = 0;
+	data = 0;
+	size = 0;
+	opened = false;
+}
+
+#else
+
+bool MappedFile::open(wxString name)
+{
+	close();
+	int file = ::open(name.fn_str(), O_RDONLY);
+	if(file < 0)
+	{
+		return false;
+	}
+	struct stat info;
+	if(fstat(file, &info) != 0)
+	{
+		::close(file);
+		return false;
+	}
+	size = info.st_size;
+	if(size != 0)
+	{
+		// Empty files can not be mapped.
+		void* view = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if(view == MAP_FAILED)
+		{
+			::close(file);
+			size = 0;
+			return false;
+		}
+		data = (const char*)view;
+	}
+	// The mapping stays valid after the descriptor is closed.
+	::close(file);
+	opened = true;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if(data != 0)
+	{
+		munmap((void*)data, size);
+	}
+	data = 0;
+	size = 0;
+	opened = false;
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <cstddef>
+
+#include <wx/string.h>
+
+// Read only view of a whole file, mapped into memory so that reading it
+// makes no copies. An empty file opens with no data.
+class MappedFile
+{
+	public:
+		MappedFile();
+		~MappedFile();
+		bool open(wxString name);
+		void close();
+		bool isOpen(){ return opened; };
+		const char* getData(){ return data; };
+		size_t getSize(){ return size; };
+	private:
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		const char* data;
+		size_t size;
+		bool opened;
+#ifdef _WIN32
+		void* file;			// HANDLEs, kept as void* to keep windows.h out of here.
+		void* mapping;
+#endif
+};
+
+#endif /*MAPPEDFILE_H_*/
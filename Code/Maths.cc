@@ -20,82 +20,107 @@
  * 
  */
  
+#include <cstring>
+
 #include "Maths.h"
 
 numFormat Maths::numberFormat = FORMAT_DECIMAL;
 
+// Two decimal digits per entry, so decimal output divides once per pair.
+const char Maths::digitPairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+const char Maths::hexDigits[] = "0123456789ABCDEF";
+const char Maths::nibbleBits[16][5] =
+{
+	"0000", "0001", "0010", "0011", "0100", "0101", "0110", "0111",
+	"1000", "1001", "1010", "1011", "1100", "1101", "1110", "1111"
+};
+
 wxString Maths::convertToBase(luint number, bool noNegative, bool negBit16, numFormat format)
+{
+	wxChar buffer[MAX_DIGITS];
+	uint length = convertToBuffer(number, buffer, noNegative, negBit16, format);
+	return wxString(buffer, length);
+}
+
+uint Maths::convertToBuffer(luint number, wxChar* buffer, bool noNegative, bool negBit16, numFormat format)
 {
 	uint numNegBits = negBit16 ? 16 : 32;
 	bool negative = !!(number & ((luint)(1)<<(numNegBits - 1)));
 	luint tempNum = negative ? ((luint)(1)<<(numNegBits)) - number : number;
-	wxString decNum, binNum, temp, hexNum;
-	bool foundOne = false;
+	// Digits are written backwards from the end of digits.
+	char digits[MAX_DIGITS];
+	char* end = digits + MAX_DIGITS;
+	char* start = end;
 	switch(format)
 	{
 		case FORMAT_DECIMAL:
-			// If number is negative, convert to correct display format including minus sign.
-			if(negative && !noNegative)
+			// Only the lowest ten digits are shown.
+			tempNum %= 10000000000ULL;
+			while(tempNum >= 100)
 			{
-				decNum += _T("-");
+				start -= 2;
+				memcpy(start, digitPairs + (tempNum % 100) * 2, 2);
+				tempNum /= 100;
 			}
-			for(uint exp = 0; exp < 10; exp++)
+			if(tempNum >= 10)
 			{
-				temp += wxString::Format(_T("%u"), uint(tempNum % 10));
-				tempNum = (tempNum - tempNum % 10) / 10;
+				start -= 2;
+				memcpy(start, digitPairs + tempNum * 2, 2);
 			}
-			
-			for(int i = temp.Len() - 1; i >= 0; i--)
+			else
 			{
-				if(temp[i] != _T('0'))
-				{
-					foundOne = true;
-				}
-				if(foundOne || i == 0)
-				{
-					decNum += temp[i];
-				}
+				*--start = '0' + (char)tempNum;
 			}
-			return decNum;
+			break;
 		case FORMAT_BINARY:
-			for(luint bit = (((luint)(-1)) >> 1) + 1; bit; bit >>= 1)
+			// Binary shows the bits of the number as it is, without a sign.
+			negative = false;
+			do
 			{
-				temp = bit & number ? _T('1') : _T('0');
-				if(temp == _T('1'))
-				{
-					foundOne = true;
-				}
-				if(foundOne || bit == 1) 
-				{
-					binNum += temp;
-				}
+				start -= 4;
+				memcpy(start, nibbleBits[number & 0xF], 4);
+				number >>= 4;
 			}
-			return binNum;
-		case FORMAT_HEX:
-			// If number is negative, convert to correct display format including minus sign.
-			if(negative && !noNegative)
+			while(number);
+			while(start < end - 1 && *start == '0')
 			{
-				hexNum += _T("-");
+				start++;
 			}
-			for(uint exp = 0; exp < 7; exp++)
-			{
-				temp += wxString::Format(_T("%X"), uint(tempNum % 16));
-				tempNum = (tempNum - tempNum % 16) / 16;
-			}
-			
-			for(int i = temp.Len() - 1; i >= 0; i--)
+			break;
+		case FORMAT_HEX:
+			// Only the lowest seven digits are shown.
+			tempNum &= 0xFFFFFFF;
+			do
 			{
-				if(temp[i] != _T('0'))
-				{
-					foundOne = true;
-				}
-				if(foundOne || i == 0)
-				{
-					hexNum += temp[i];
-				}
+				*--start = hexDigits[tempNum & 0xF];
+				tempNum >>= 4;
 			}
-			return hexNum;
+			while(tempNum);
+			break;
+	}
+	uint length = 0;
+	if(negative && !noNegative)
+	{
+		buffer[length++] = _T('-');
+	}
+	while(start < end)
+	{
+		buffer[length++] = *start++;
+	}
+	return length;
+}
+
+void Maths::convertRangeToBase(const std::vector<luint>& numbers, std::vector<wxString>& strings, bool noNegative, bool negBit16, numFormat format)
+{
+	wxChar buffer[MAX_DIGITS];
+	strings.resize(numbers.size());
+	for(size_t i = 0; i < numbers.size(); i++)
+	{
+		strings[i].assign(buffer, convertToBuffer(numbers[i], buffer, noNegative, negBit16, format));
 	}
-	
-	return _T("0");
 }
@@ -25,6 +25,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 #include <wx/string.h>
 
@@ -41,9 +42,19 @@ class Maths
 {
 	public:
 		static wxString convertToBase(luint number, bool noNegative = false, bool negBit16 = false, numFormat format = numberFormat);
+		// As convertToBase, but written into buffer, which must hold
+		// MAX_DIGITS characters. Returns the number of characters written.
+		static uint convertToBuffer(luint number, wxChar* buffer, bool noNegative = false, bool negBit16 = false, numFormat format = numberFormat);
+		// Convert a whole range of numbers at once, reusing the strings
+		// already in strings.
+		static void convertRangeToBase(const std::vector<luint>& numbers, std::vector<wxString>& strings, bool noNegative = false, bool negBit16 = false, numFormat format = numberFormat);
 		static void setFormat(numFormat newFormat){ numberFormat = newFormat; };
+		static const uint MAX_DIGITS = 64;	// Longest output, all 64 bits in binary.
 	private:
 		static numFormat numberFormat;
+		static const char digitPairs[];
+		static const char hexDigits[];
+		static const char nibbleBits[16][5];	// Binary digits of each nibble.
 };
 
 
@@ -0,0 +1,72 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+ 
+#include "MemoryStore.h"
+
+MemoryStore::MemoryStore(luint flatSize)
+: flat(flatSize, 0)
+{
+	journal = 0;
+	journalId = 0;
+}
+
+void MemoryStore::clear()
+{
+	flat.assign(flat.size(), 0);
+	pages.clear();
+}
+
+luint MemoryStore::getPaged(luint address) const
+{
+	auto page = pages.find(address >> PAGE_BITS);
+	if(page == pages.end())
+	{
+		return 0;
+	}
+	return page->second[address & (PAGE_SIZE - 1)];
+}
+
+void MemoryStore::setPaged(luint address, luint val)
+{
+	auto page = pages.find(address >> PAGE_BITS);
+	if(page == pages.end())
+	{
+		if(val == 0)
+		{
+			// Unwritten words already read as zero.
+			return;
+		}
+		page = pages.emplace(address >> PAGE_BITS, std::vector<luint>(PAGE_SIZE, 0)).first;
+	}
+	page->second[address & (PAGE_SIZE - 1)] = val;
+}
+
+void MemoryStore::record(luint address, luint val)
+{
+	luint oldValue = get(address);
+	if(oldValue != val)
+	{
+		MemoryWrite write = { journalId, address, oldValue, val, 0 };
+		journal->push_back(write);
+	}
+}
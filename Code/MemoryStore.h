@@ -0,0 +1,82 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+ 
+#ifndef MEMORY_STORE_H_
+#define MEMORY_STORE_H_
+
+#include <map>
+#include <vector>
+
+#include "Types.h"
+
+// A change made to a MemoryStore, recorded while a journal is attached.
+struct MemoryWrite
+{
+	uint memory;        // Id given to MemoryStore::setJournal().
+	luint address;
+	luint oldValue;
+	luint newValue;
+	luint cycle;        // Model::getCycle() when the step that made it began.
+};
+
+// Word storage for the memory components. Addresses below the flat size are
+// kept in one contiguous array; any other address goes to a fixed size page
+// that is only created when it is first written, so reads never allocate.
+class MemoryStore
+{
+	public:
+		MemoryStore(luint flatSize);
+		luint get(luint address) const { return (address < flat.size()) ? flat[address] : getPaged(address); };
+		void set(luint address, luint val)
+		{
+			if(journal != 0)
+			{
+				record(address, val);
+			}
+			if(address < flat.size())
+			{
+				flat[address] = val;
+			}
+			else
+			{
+				setPaged(address, val);
+			}
+		};
+		void clear();
+		// Copy the contents of other. The journal is not copied.
+		void assign(const MemoryStore& other){ flat = other.flat; pages = other.pages; };
+		// Append every change of a stored value to journal, tagged with id.
+		void setJournal(std::vector<MemoryWrite>* journal, uint id){ this->journal = journal; journalId = id; };
+	private:
+		void record(luint address, luint val);
+		luint getPaged(luint address) const;
+		void setPaged(luint address, luint val);
+		static const uint PAGE_BITS = 8;
+		static const luint PAGE_SIZE = ((luint)1)<<PAGE_BITS;
+		std::vector<luint> flat;
+		std::map<luint, std::vector<luint>> pages; // Keyed by address >> PAGE_BITS.
+		std::vector<MemoryWrite>* journal;
+		uint journalId;
+};
+
+#endif /*MEMORY_STORE_H_*/
@@ -0,0 +1,80 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include "Model.h"
+#include "Maths.h"
+
+#include "MemoryTable.h"
+
+MemoryTable::MemoryTable(Model* processor)
+{
+	this->processor = processor;
+}
+
+int MemoryTable::GetNumberRows()
+{
+	return Model::MAX_DATA;
+}
+
+wxString MemoryTable::GetValue(int row, int WXUNUSED(col))
+{
+	return Maths::convertToBase(processor->getParserMemData(row), false, false, FORMAT_DECIMAL);
+}
+
+void MemoryTable::SetValue(int row, int WXUNUSED(col), const wxString& value)
+{
+	processor->setParserMemData(row, parseValue(value));
+}
+
+wxString MemoryTable::GetRowLabelValue(int row)
+{
+	return wxString::Format(_T("%d"), row);
+}
+
+wxString MemoryTable::GetColLabelValue(int WXUNUSED(col))
+{
+	return _T("Data");
+}
+
+luint MemoryTable::parseValue(const wxString& value)
+{
+	bool minus = (value.Len() > 1 && value[0] == _T('-'));
+	luint numVal = 0;
+	for(size_t i = minus ? 1 : 0; i < value.Len(); i++)
+	{
+		if(value[i] < _T('0') || value[i] > _T('9'))
+		{
+			return 0;
+		}
+		numVal = numVal * 10 + (value[i] - _T('0'));
+		if(numVal > Model::MAX_MEM_VAL / 2)
+		{
+			return 0;
+		}
+	}
+	if(minus && numVal)
+	{
+		// Convert number to 2's complement negative number.
+		numVal = ((luint)(1)<<32) - numVal;
+	}
+	return numVal;
+}
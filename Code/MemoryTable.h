@@ -0,0 +1,53 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef MEMORYTABLE_H_
+#define MEMORYTABLE_H_
+
+#include <wx/wx.h>
+#include <wx/grid.h>
+
+#include "Types.h"
+
+class Model;
+
+// Grid table showing the parser's initial data memory directly, so the grid
+// keeps no copy of its own and an edit only touches the changed word.
+class MemoryTable : public wxGridTableBase
+{
+	public:
+		MemoryTable(Model* processor);
+		virtual int GetNumberRows();
+		virtual int GetNumberCols(){ return 1; };
+		virtual bool IsEmptyCell(int WXUNUSED(row), int WXUNUSED(col)){ return false; };
+		virtual wxString GetValue(int row, int col);
+		virtual void SetValue(int row, int col, const wxString& value);
+		virtual wxString GetRowLabelValue(int row);
+		virtual wxString GetColLabelValue(int col);
+		// Word for a typed decimal value, negatives as two's complement.
+		// Anything else, or a value outside 32 bit signed range, gives 0.
+		static luint parseValue(const wxString& value);
+	private:
+		Model* processor;
+};
+
+#endif /*MEMORYTABLE_H_*/
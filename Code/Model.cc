@@ -20,22 +20,30 @@
  * 
  */
  
+#include <algorithm>
+
 #include "Component.h"
 #include "Scanner.h"
+#include "ProgramImage.h"
 #include "Parser.h"
 #include "Config.h"
 #include "Link.h"
+#include "Netlist.h"
+#include "Interpreter.h"
 
 #include "Model.h"
 
-std::map<configName, bool> Model::bools;
-
 Model::Model()
-	: smz(std::make_unique<Scanner>(_T(""))), pmz(std::make_unique<Parser>(smz.get()))
+	: context(std::make_unique<ComponentContext>()), smz(std::make_unique<Scanner>(_T(""))), pmz(std::make_unique<Parser>(smz.get()))
 {
 	creatingConnection = false;
 	layout = LAYOUT_SIMPLE;
 	validInstructions = false;
+	simulationMode = SIM_COMPILED;
+	evaluations = 0;
+	cycle = 0;
+	historyStateValid = false;
+	timings = nullptr;
 }
 
 void Model::resetColours()
@@ -75,35 +83,51 @@ wxColour Model::getColourForInstruction(uint loc)
 	{
 		if(programCounter->getOutput() == loc)
 		{
-			return Component::getwxColour(STAGE1_COLOUR);
+			return context->getwxColour(STAGE1_COLOUR);
 		}
 	}
 	else
 	{
 		if(loc == currAddr[0])
 		{
-			return Component::getwxColour(STAGE1_COLOUR);
+			return context->getwxColour(STAGE1_COLOUR);
 		}
 		else if(loc == currAddr[1])
 		{
-			return Component::getwxColour(STAGE2_COLOUR);
+			return context->getwxColour(STAGE2_COLOUR);
 		}
 		else if(loc == currAddr[2])
 		{
-			return Component::getwxColour(STAGE3_COLOUR);
+			return context->getwxColour(STAGE3_COLOUR);
 		}
 		else if(loc == currAddr[3])
 		{
-			return Component::getwxColour(STAGE4_COLOUR);
+			return context->getwxColour(STAGE4_COLOUR);
 		}
 		else if(loc == currAddr[4])
 		{
-			return Component::getwxColour(STAGE5_COLOUR);
+			return context->getwxColour(STAGE5_COLOUR);
 		}
 	}
+	if(isBreakpoint(loc))
+	{
+		return wxColour(255, 200, 200);
+	}
 	return wxColour(255, 255, 255);
 }
 
+void Model::getPipelineAddresses(std::vector<luint>& addresses)
+{
+	if(layout == LAYOUT_SIMPLE)
+	{
+		addresses.assign(1, programCounter->getOutput());
+	}
+	else
+	{
+		addresses.assign(currAddr, currAddr + 5);
+	}
+}
+
 void Model::getFileContents(wxString & str)
 {
 	str.Clear();
@@ -124,7 +148,7 @@ void Model::resetup()
 void Model::resetup(Layout newLayout)
 {
 	components.clear();
-	Component::resetPipelineCycle();
+	context->resetPipelineCycle();
 	layout = newLayout;
 	setup();
 	getParsedInstructions();
@@ -137,6 +161,8 @@ void Model::resetup(Layout newLayout)
 	currInstr[0] = pmz->getInstructionSymbol(addr);
 	currAddr[0] = addr;
 	lastAddrLoc = 0;
+	counters.reset(currInstr[0]);
+	resetStageAddresses(addr);
 	if(layout != LAYOUT_SIMPLE)
 	{
 	 	// With non simple layout set all components to active.
@@ -148,16 +174,30 @@ void Model::resetup(Layout newLayout)
  	}
 }
 
-void Model::loadFile(wxString file)
+bool Model::loadFile(wxString file)
 {
 	smz.reset();
 	pmz.reset();
 	
-	smz = std::make_unique<Scanner>(file);
+	bool image = ProgramImage::isImageFile(file);
+	smz = std::make_unique<Scanner>(image ? wxString(_T("")) : file);
 	pmz = std::make_unique<Parser>(smz.get());
 
-	if(smz->checkFile())
+	bool read = false;
+	if(image)
+	{
+		// Already assembled, so parse() has nothing left to do.
+		ProgramImage programImage;
+		read = programImage.read(file) && pmz->loadImage(programImage);
+		if(!read)
+		{
+			std::cout << "File Error" << std::endl;
+		}
+		validInstructions = read && getNumberOfErrors() == 0;
+	}
+	else if(smz->checkFile())
 	{
+		read = true;
 		validInstructions = pmz->readIn();
 	}
 	else
@@ -165,11 +205,45 @@ void Model::loadFile(wxString file)
 		validInstructions = false;
 	}
 	getParsedInstructions();
+	return read;
 }
 
-void Model::saveFile(wxString file)
+bool Model::loadProgram(wxString file)
 {
-	if(file != _T(""))
+	loadFile(file);
+	parse(_T(""));
+	resetup();
+	if(!validInstructions || getNumberOfErrors() != 0)
+	{
+		return false;
+	}
+	loadInitialData();
+	getParsedInstructions();
+	return true;
+}
+
+luint Model::getProgramEnd()
+{
+	luint end = 0;
+	for(uint i = 0; i < MAX_INSTRUCTIONS; i += 4)
+	{
+		if(getMemoryData(ID_INSTRUCTION_LIST, i) != 0)
+		{
+			end = i + 4;
+		}
+	}
+	return end;
+}
+
+bool Model::saveFile(wxString file)
+{
+	if(ProgramImage::isImageFile(file))
+	{
+		ProgramImage image;
+		pmz->saveImage(image, MAX_INSTRUCTIONS / 4, MAX_DATA);
+		return image.write(file);
+	}
+	else if(file != _T(""))
 	{
 		wxString curLine;
 		uint address = 0;
@@ -196,7 +270,9 @@ void Model::saveFile(wxString file)
 		}
 		while(address < MAX_DATA);
 		sfile.close();
+		return !sfile.fail();
 	}
+	return false;
 }
 
 void Model::parse(wxString str)
@@ -223,6 +299,32 @@ void Model::parse(wxString str)
 	}
 }
 
+bool Model::reassemble(wxString str)
+{
+	wxString localStr = str;
+	localStr.Replace(_T("Data"), _T(""));
+	if(localStr == _T("") || !pmz->parseInstructions(localStr))
+	{
+		return false;
+	}
+	validInstructions = true;
+	bool changed = false;
+	for(uint i = 0; i < MAX_INSTRUCTIONS; i += 4)
+	{
+		luint word = pmz->getInstruction(i);
+		if(memories[ID_INSTRUCTION_LIST]->getData(i) != word)
+		{
+			memories[ID_INSTRUCTION_LIST]->setData(i, word);
+			changed = true;
+		}
+	}
+	if(changed)
+	{
+		history.clear();
+	}
+	return true;
+}
+
 luint Model::getParserMemData(luint address)
 {
 	return pmz->getMemData(address);
@@ -233,6 +335,17 @@ void Model::setParserMemData(luint address, luint data)
 	pmz->setMemData(address, data);
 }
 
+void Model::loadInitialData()
+{
+	MemoryStore image(MAX_DATA);
+	for(uint i = 0; i < MAX_DATA; i++)
+	{
+		image.set(i, pmz->getMemData(i));
+	}
+	history.clear();
+	memories[ID_DATA_LIST]->setStore(image);
+}
+
 void Model::getParsedInstructions()
 {
 	if(validInstructions)
@@ -298,6 +411,7 @@ void Model::getFieldedInstruction(luint address, wxString & str)
 
 void Model::setup()
 {
+	forwardingUnit.reset();
 	if(layout == LAYOUT_SIMPLE)
 	{
 		auto PC0 = std::make_shared<PC>(layout, 6, 67, 5, 8, _T("PC"));
@@ -1110,6 +1224,7 @@ void Model::setup()
 		MEMWBReg20->setInstrActive(4, SYM_ADDI, true);
 		MEMWBReg20->setInstrActive(4, SYM_EOF, true);
 		auto Forwarding21 = std::make_shared<Forwarding>(132, 9, 30, 10, _T("Forwarding\n     Unit"));
+		forwardingUnit = Forwarding21;
 		components.push_back(Forwarding21);
 		Forwarding21->setPipelineStage(2);
 		Forwarding21->setInstrActive(4, SYM_EOF, true);
@@ -1410,81 +1525,111 @@ void Model::setup()
 		PC0->setActive();
 		PC0->confirmActive();
 	}
+	for(auto&& i : components)
+	{
+		i->setContext(context.get());
+	}
+	// Flatten the layout for the compiled simulation mode.
+	netlist = std::make_unique<Netlist>(components);
+	buildSpatialIndex();
+	for(auto&& i : memories)
+	{
+		i.second->setJournal(&memoryWrites, i.first);
+	}
+	history.clear();
+	historyStateValid = false;
+	cycle = 0;
 }
 
 void Model::setHighlightInstruction(luint instr, bool valid)
 {		
-	Component::setCurrentInstruction(-1);	
+	context->setCurrentInstruction(-1);	
 	if(valid)
 	{
 		for(uint i = 0; i < 5; i++)
 		{
 			if(instr == currAddr[i])
 			{
-				Component::setCurrentInstruction(i);
+				context->setCurrentInstruction(i);
 			}
 		}
 	}	
 }
 
+void Model::setColour(configName name, wxColour colour)
+{
+	context->setColour(name, colour);
+}
+
+void Model::setAreDataLinesBold(bool val)
+{
+	context->setAreDataLinesBold(val);
+}
+
+void Model::setHighlightSingleInstruction(bool val)
+{
+	context->setHighlightSingleInstruction(val);
+}
+
+void Model::setDetailLevel(DetailLevel level)
+{
+	context->setDetailLevel(level);
+}
+
+DetailLevel Model::getDetailLevel()
+{
+	return context->getDetailLevel();
+}
+
+void Model::setSimulationMode(SimulationMode mode)
+{
+	// The compiled netlist moves values without going through the input
+	// links, so nothing is known to be up to date after switching.
+	for(auto&& i : components)
+	{
+		i->markDirty();
+	}
+	simulationMode = mode;
+}
+
 void Model::step()
 {
+	ScopedTiming timing(timings, TIMING_STEP);
+	bool recording = (history.getMaxBytes() != 0);
+	if(recording && !historyStateValid)
+	{
+		saveState(historyState);
+	}
+	memoryWrites.clear();
+	evaluations = 0;
+	bool pipelined = (layout != LAYOUT_SIMPLE);
+	bool flushed = false;
 	for(int steps = 0; steps < (layout == LAYOUT_SIMPLE ? 1 : (Component::pipelineClockSteps)) ; steps++)
 	{
-		
-		bool reset = false;
-	 	// Step all components (update outputs based on inputs).
-	 	for(auto&& i : components)
+		bool reset;
+		if(simulationMode == SIM_COMPILED)
 		{
-			if(i->getType() != NODE_TYPE)
-			{
-	 			i->step();
-	 		}
-	 	}
-		// Pre Step all components (update inputs based on outputs connected to said inputs).
-		for(auto&& i : components)
+			reset = netlist->step(pipelined);
+			evaluations += netlist->getNumComponents();
+		}
+		else
 		{
-	 		i->preStep();
-	 	}
-	 	// Prevent activity changes from propagating two steps in one.
-	 	for(auto&& i : components)
+			reset = stepComponents(pipelined);
+		}
+		// Flush pipeline if branch is taken.
+		if(pipelined && branchCheckGate->getOutput() == 1)
 		{
-			if(i->getType() != NODE_TYPE)
-			{
-	 			i->confirmActive();
-			}
-			if(i->getType() == PC_TYPE)
-			{
-				if(i->allInputsActive())
-				{
-					reset = true;
-				}
-			}
-	 	}
-	 	// Flush pipeline if branch is taken.
-	 	if(layout != LAYOUT_SIMPLE)
-	 	{
-	 		// Branch is being taken.
-	 		if(branchCheckGate->getOutput() == 1)
-	 		{
-	 			buffers[0]->reset();
-	 		}
-	 		
-	 		// With non simple layout set all components to active.
-	 		for(auto&& i : components)
-			{
-				if(i->getType() != NODE_TYPE)
-				{
-	 				i->setActive();
-				}
-				i->resetOldActiveLinkColor();
-	 		}
-	 	}
-	 	
-	 	if(reset && layout == LAYOUT_SIMPLE)
-	 	{
-	 		this->reset();
-	 	}
+			buffers[0]->reset();
+			flushed = true;
+		}
+		if(reset && !pipelined)
+		{
+			this->reset();
+		}
+	}
+	for(auto&& write : memoryWrites)
+	{
+		write.cycle = cycle;
 	}
 	luint addr = programCounter->getOutput();
 	for(int i = 4; i > 0; i--)
@@ -1495,10 +1640,341 @@ void Model::step()
 	lastAddrLoc++;
 	lastAddrLoc %= 5;
 	currAddr[lastAddrLoc] = addr;
-	if(layout != LAYOUT_SIMPLE)
+	if(pipelined)
+	{
+		context->incrementPipelineCycle();
+		bool forwardA = forwardingUnit && forwardingUnit->getLink(FORWARDING_MUXA)->getVal() != 0;
+		bool forwardB = forwardingUnit && forwardingUnit->getLink(FORWARDING_MUXB)->getVal() != 0;
+		counters.addCycle(PerformanceCounters::MAX_DEPTH, currInstr[0], flushed, forwardA, forwardB);
+		if(flushed)
+		{
+			stageAddrs[0] = NO_ADDRESS;
+		}
+		for(uint i = 4; i > 0; i--)
+		{
+			stageAddrs[i] = stageAddrs[i - 1];
+		}
+		stageAddrs[0] = addr;
+	}
+	else if(programCounter->atCycleStart())
+	{
+		counters.addCycle(1, currInstr[0], false, false, false);
+	}
+	cycle++;
+	if(recording)
+	{
+		saveState(nextState);
+		history.record(historyState, nextState, memoryWrites);
+		historyState.swap(nextState);
+	}
+	historyStateValid = recording;
+}
+
+bool Model::stepBack()
+{
+	if(!historyStateValid)
+	{
+		saveState(historyState);
+		historyStateValid = true;
+	}
+	std::vector<MemoryWrite> writes;
+	if(!history.undo(historyState, writes))
+	{
+		return false;
+	}
+	loadState(historyState);
+	// Undoing the writes journals them again, so the journal holds what
+	// this step back changed.
+	memoryWrites.clear();
+	for(auto i = writes.rbegin(); i != writes.rend(); ++i)
+	{
+		memories[i->memory]->setData(i->address, i->oldValue);
+	}
+	cycle--;
+	for(auto&& write : memoryWrites)
+	{
+		write.cycle = cycle;
+	}
+	return true;
+}
+
+bool Model::jumpToCycle(luint target)
+{
+	if(target > cycle + MAX_JUMP_AHEAD)
+	{
+		return false;
+	}
+	// Earlier cycles are undone from the history, later ones are stepped.
+	while(cycle > target)
+	{
+		if(!stepBack())
+		{
+			return false;
+		}
+	}
+	while(cycle < target)
+	{
+		step();
+	}
+	return true;
+}
+
+void Model::saveState(std::vector<luint>& state)
+{
+	const std::vector<luint>& values = netlist->getValues();
+	state.assign(values.begin(), values.end());
+	for(auto&& i : components)
+	{
+		i->saveState(state);
+	}
+	for(uint i = 0; i < 5; i++)
+	{
+		state.push_back(currInstr[i]);
+		state.push_back(currAddr[i]);
+	}
+	state.push_back(lastAddrLoc);
+	state.insert(state.end(), stageAddrs, stageAddrs + 5);
+	state.push_back(context->getPipelineCycle());
+	counters.saveState(state);
+}
+
+void Model::loadState(const std::vector<luint>& state)
+{
+	std::vector<luint>& values = netlist->getValues();
+	std::copy(state.begin(), state.begin() + values.size(), values.begin());
+	const luint* pos = state.data() + values.size();
+	for(auto&& i : components)
+	{
+		i->loadState(pos);
+	}
+	for(uint i = 0; i < 5; i++)
+	{
+		currInstr[i] = (Symbol)*pos++;
+		currAddr[i] = *pos++;
+	}
+	lastAddrLoc = (uint)*pos++;
+	for(uint i = 0; i < 5; i++)
+	{
+		stageAddrs[i] = *pos++;
+	}
+	context->setPipelineCycle((uint)*pos++);
+	counters.loadState(pos);
+}
+
+void Model::copySimulation(Model& other)
+{
+	// The parser keeps reading through other's scanner, which is fine as a
+	// copy only ever looks up the parsed program.
+	*pmz = *other.pmz;
+	validInstructions = other.validInstructions;
+	breakpoints = other.breakpoints;
+	setSimulationMode(other.simulationMode);
+	resetup(other.layout);
+	for(auto&& i : other.memories)
+	{
+		memories[i.first]->setStore(i.second->getStore());
+	}
+	std::vector<luint> state;
+	other.saveState(state);
+	loadState(state);
+	memoryWrites.clear();
+	cycle = other.cycle;
+	history = other.history;
+	historyStateValid = false;
+}
+
+void Model::takeSnapshot(ModelSnapshot& snapshot)
+{
+	saveState(snapshot.state);
+	for(auto&& i : memories)
+	{
+		snapshot.memories.emplace(i.first, MemoryStore(0)).first->second.assign(i.second->getStore());
+	}
+	snapshot.cycle = cycle;
+	snapshot.atBreakpoint = atBreakpoint();
+}
+
+void Model::loadSnapshot(const ModelSnapshot& snapshot)
+{
+	loadState(snapshot.state);
+	for(auto&& i : snapshot.memories)
+	{
+		memories[i.first]->setStore(i.second);
+	}
+	cycle = snapshot.cycle;
+	historyStateValid = false;
+}
+
+luint Model::run(luint maxCycles)
+{
+	// Always take the first step so a run can continue from a breakpoint.
+	luint cycles = 0;
+	while(cycles < maxCycles)
+	{
+		step();
+		cycles++;
+		if(atBreakpoint())
+		{
+			break;
+		}
+	}
+	return cycles;
+}
+
+luint Model::runToEnd(luint end, luint maxCycles)
+{
+	// Count clock cycles rather than steps, as the single cycle layout
+	// takes several steps for each.
+	luint cycles = 0;
+	while(cycles < maxCycles && !atEnd(end))
+	{
+		step();
+		if(layout != LAYOUT_SIMPLE || programCounter->atCycleStart())
+		{
+			cycles++;
+		}
+	}
+	return cycles;
+}
+
+bool Model::atEnd(luint end)
+{
+	if(layout == LAYOUT_SIMPLE)
 	{
-		Component::incrementPipelineCycle();
+		return programCounter->atCycleStart() && programCounter->getOutput() >= end;
 	}
+	// Every instruction from before end, taken branches included, has left
+	// the pipeline and the fetch is at end or beyond.
+	for(auto&& addr : stageAddrs)
+	{
+		if(addr < end)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void Model::resetStageAddresses(luint fetched)
+{
+	for(uint i = 0; i < 5; i++)
+	{
+		stageAddrs[i] = NO_ADDRESS;
+	}
+	stageAddrs[0] = fetched;
+}
+
+bool Model::atBreakpoint()
+{
+	return !breakpoints.empty() && programCounter->atCycleStart() && isBreakpoint(programCounter->getOutput());
+}
+
+void Model::toggleBreakpoint(luint address)
+{
+	if(!breakpoints.erase(address))
+	{
+		breakpoints.insert(address);
+	}
+}
+
+luint Model::fastForward(luint count, luint stopAddress)
+{
+	// Start from a fresh datapath holding the program and initial data.
+	resetup();
+	Interpreter isa;
+	for(uint i = 0; i < MAX_INSTRUCTIONS; i += 4)
+	{
+		isa.setInstruction(i, memories[ID_INSTRUCTION_LIST]->getData(i));
+	}
+	for(uint i = 0; i < MAX_DATA; i++)
+	{
+		luint data = pmz->getMemData(i);
+		if(data)
+		{
+			isa.setData(i, data);
+		}
+	}
+	luint executed = isa.run(count, stopAddress);
+	// Hand the architectural state over to the components.
+	for(uint i = 0; i < MAX_REGISTERS; i++)
+	{
+		memories[ID_REGISTER_LIST]->setData(i, isa.getRegister(i));
+	}
+	for(auto&& i : isa.getData())
+	{
+		memories[ID_DATA_LIST]->setData(i.first, i.second);
+	}
+	luint addr = isa.getPC();
+	programCounter->setAddress(addr);
+	// Let the new address reach the instruction memory before the first step.
+	for(auto&& i : components)
+	{
+		i->preStep();
+	}
+	currInstr[0] = pmz->getInstructionSymbol(addr);
+	currAddr[0] = addr;
+	counters.reset(currInstr[0]);
+	resetStageAddresses(addr);
+	return executed;
+}
+
+bool Model::stepComponents(bool pipelined)
+{
+	bool reset = false;
+	bool eventDriven = (simulationMode == SIM_EVENT_DRIVEN);
+	// Step all components (update outputs based on inputs).
+	for(auto&& i : components)
+	{
+		if(i->getType() == NODE_TYPE)
+		{
+			continue;
+		}
+		if(eventDriven && i->isCombinational() && !i->isDirty())
+		{
+			// Inputs unchanged so the outputs are too, only activity can change.
+			if(!i->isActive() && i->allInputsActive())
+			{
+				i->setActive();
+			}
+			continue;
+		}
+		i->clearDirty();
+		i->step();
+		evaluations++;
+	}
+	// Pre Step all components (update inputs based on outputs connected to said inputs).
+	for(auto&& i : components)
+	{
+		i->preStep();
+	}
+	// Prevent activity changes from propagating two steps in one.
+	for(auto&& i : components)
+	{
+		if(i->getType() != NODE_TYPE)
+		{
+			i->confirmActive();
+		}
+		if(i->getType() == PC_TYPE)
+		{
+			if(i->allInputsActive())
+			{
+				reset = true;
+			}
+		}
+	}
+	if(pipelined)
+	{
+		// With non simple layout set all components to active.
+		for(auto&& i : components)
+		{
+			if(i->getType() != NODE_TYPE)
+			{
+				i->setActive();
+			}
+			i->resetOldActiveLinkColor();
+		}
+	}
+	return reset;
 }
 
 void Model::reset()
@@ -1559,13 +2035,13 @@ Model::~Model()
 
 }
 
-void Model::draw(wxPoint mousePos, double scale)
+void Model::draw(Renderer& renderer, wxPoint mousePos, double scale)
 {	
 	bool simpleLayout = (layout == LAYOUT_SIMPLE);
 	bool showControl = bools[SHOW_CONTROL_LINES];
 	bool showPC = bools[SHOW_PC_LINES];
 	
-	Component::drawBackground();
+	Component::drawBackground(renderer, *context);
 	for(auto&& i : components)
 	{
 		if(showControl || (!(i->getIsControl())))
@@ -1573,9 +2049,9 @@ void Model::draw(wxPoint mousePos, double scale)
 			if(showPC || (!(i->getIsPC())))
 			{
  				
- 				i->drawConnectors(showControl, showPC, currInstr, simpleLayout);
- 				i->drawConnections(showControl, showPC, currInstr, simpleLayout);
- 				i->draw(showControl, showPC, currInstr, simpleLayout, scale);
+ 				i->drawConnectors(renderer, showControl, showPC, currInstr, simpleLayout);
+ 				i->drawConnections(renderer, showControl, showPC, currInstr, simpleLayout);
+ 				i->draw(renderer, showControl, showPC, currInstr, simpleLayout, scale);
 			}
 		}
 
@@ -1585,63 +2061,83 @@ void Model::draw(wxPoint mousePos, double scale)
  	{
  		int newX = (int)(oLink->getComp()->getX() + oLink->getX() * oLink->getComp()->getW());
  		int newY = (int)(oLink->getComp()->getY() + oLink->getY() * oLink->getComp()->getH());
- 		glPushAttrib(GL_COLOR_BUFFER_BIT);
-		glColor3f(0.0, 0.0, 0.0);
-		glBegin(GL_LINE_STRIP);
-		glVertex2f(newX, newY);
+ 		renderer.pushState();
+		renderer.setColour(Color(0.0, 0.0, 0.0, 1.0));
+		renderer.begin(PRIMITIVE_LINE_STRIP);
+		renderer.vertex(newX, newY);
 		for(auto&& vertex : vertices)
 		{
-			glVertex2f(vertex.x, vertex.y);
+			renderer.vertex(vertex.x, vertex.y);
 		}		
-		glVertex2f(mousePos.x, mousePos.y);
-		glEnd();
-		glPopAttrib();
+		renderer.vertex(mousePos.x, mousePos.y);
+		renderer.end();
+		renderer.popState();
  	}
 }
 
 Component* Model::findComponent(wxPoint mousePos)
 {
+	uint i = componentIndex.find(mousePos.x, mousePos.y);
+	return (i == SpatialIndex::NOT_FOUND) ? nullptr : indexedComponents[i];
+}
+
+Link* Model::findLink(wxPoint mousePos)
+{
+	uint i = linkIndex.find(mousePos.x, mousePos.y);
+	return (i == SpatialIndex::NOT_FOUND) ? nullptr : indexedLinks[i];
+}
+
+void Model::getLayoutBounds(Coord& min, Coord& max)
+{
+	min = Coord(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+	max = Coord(-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max());
+	auto add = [&](double x, double y)
+	{
+		min = Coord(std::min(min.x, x), std::min(min.y, y));
+		max = Coord(std::max(max.x, x), std::max(max.y, y));
+	};
 	for(auto&& comp : components)
 	{
-		if(comp->getX() < mousePos.x && comp->getX() + comp->getW() > mousePos.x)
+		add(comp->getX(), comp->getY());
+		add(comp->getX() + comp->getW(), comp->getY() + comp->getH());
+		uint slot = 0;
+		for(Link *ln = comp->getLink(slot); ln != 0; ln = comp->getLink(++slot))
 		{
-			if(comp->getY() < mousePos.y && comp->getY() + comp->getH() > mousePos.y)
+			for(auto&& vertex : ln->getVertices())
 			{
-				return comp.get();
+				add(vertex.x, vertex.y);
 			}
 		}
 	}
-	
-	return nullptr;
 }
 
-Link* Model::findLink(wxPoint mousePos)
+void Model::buildSpatialIndex()
 {
-	uint slot;
+	componentIndex.clear();
+	indexedComponents.clear();
+	linkIndex.clear();
+	indexedLinks.clear();
 	for(auto&& comp : components)
 	{
+		componentIndex.insert(comp->getX(), comp->getY(), comp->getX() + comp->getW(), comp->getY() + comp->getH());
+		indexedComponents.push_back(comp.get());
 		if(comp->getType() != NODE_TYPE)
 		{
-			slot = 0;
+			uint slot = 0;
 			Link *ln = comp->getLink(slot);
 			while(ln != 0)
 			{
 				if(!ln->isOutput() || ln->isConnected())
 				{
-					if(ln->getTipPos(LEFT) < mousePos.x && ln->getTipPos(RIGHT) > mousePos.x)
-					{
-						if(ln->getTipPos(BOTTOM) < mousePos.y && ln->getTipPos(TOP) > mousePos.y)
-						{
-							return ln;
-						}
-					}
+					linkIndex.insert(ln->getTipPos(LEFT), ln->getTipPos(BOTTOM), ln->getTipPos(RIGHT), ln->getTipPos(TOP));
+					indexedLinks.push_back(ln);
 				}
 				ln = comp->getLink(++slot);
 			}
 		}
 	}
-	
-	return 0;
+	componentIndex.build();
+	linkIndex.build();
 }
 
 luint Model::getMemoryData(uint mem, luint address)
@@ -1651,6 +2147,7 @@ luint Model::getMemoryData(uint mem, luint address)
 
 void Model::setMemoryData(uint mem, luint address, luint data)
 {
+	history.clear();
 	memories[mem]->setData(address, data);
 }
 
@@ -30,6 +30,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 
 #include <wx/gdicmn.h>
 #include <wx/utils.h>
@@ -38,19 +39,37 @@
 
 #include "Enums.h"
 #include "Types.h"
+#include "Coord.h"
 #include "Config.h"
+#include "History.h"
+#include "PerformanceCounters.h"
+#include "SpatialIndex.h"
+#include "TimingStats.h"
 
 class Component;
+class ComponentContext;
 class Link;
 class Scanner;
+class Renderer;
+class Netlist;
 class Parser;
 class Memory;
 class PipelineRegister;
 class PC;
+class Forwarding;
 class AndGate;
 class OutputLink;
 class InputLink;
-struct Coord;
+
+// Everything a GUI shows of a model that is being stepped elsewhere, taken
+// between steps (see SimulationWorker).
+struct ModelSnapshot
+{
+	std::vector<luint> state;				// As Model::saveState().
+	std::map<uint, MemoryStore> memories;	// Keyed by memory id.
+	luint cycle;
+	bool atBreakpoint;
+};
 
 class Model
 {
@@ -63,19 +82,78 @@ class Model
 		void getFileContents(wxString & str);
 		luint getParserMemData(luint address);
 		void setParserMemData(luint address, luint data);
+		// Replace data memory with the parser's initial data in one copy.
+		void loadInitialData();
 		void parse(wxString str);
+		// Assemble str into instruction memory in place, writing only the
+		// words that changed and leaving the rest of the datapath running.
+		// Returns false if str is empty, has errors or has a data section,
+		// when parse() and resetup() are needed instead.
+		bool reassemble(wxString str);
+		bool hasValidInstructions(){ return validInstructions; };
 		void getInstructionString(luint address, wxString& instr, bool & err);
 		void setup();
 		void resetup();
 		void resetup(Layout newLayout);
-		void loadFile(wxString file);
-		void saveFile(wxString file);
+		// Returns false if the file could not be read.
+		bool loadFile(wxString file);
+		// Read a program, parse it and load its data ready to run, without the
+		// editor. Returns false if it has errors.
+		bool loadProgram(wxString file);
+		// Address after the last non-zero instruction word.
+		luint getProgramEnd();
+		// Returns false if the file could not be written.
+		bool saveFile(wxString file);
 		void step();
+		luint fastForward(luint count, luint stopAddress = NO_STOP_ADDRESS);
+		bool stepBack();
+		// Step back through the history or forward by at most
+		// MAX_JUMP_AHEAD cycles. Returns false if the target is further
+		// ahead, which leaves the cycle as it is, or further back than the
+		// history holds.
+		bool jumpToCycle(luint target);
+		luint getCycle(){ return cycle; };
+		luint getOldestCycle(){ return cycle - history.getNumCycles(); };
+		History& getHistory(){ return history; };
+		PerformanceCounters& getCounters(){ return counters; };
+		// Memory changes made by the latest step(), or those undone by the
+		// latest stepBack(), in the order they were made.
+		const std::vector<MemoryWrite>& getMemoryWrites(){ return memoryWrites; };
+		// Time each step into stats, or stop timing if it is null.
+		void setTimingStats(TimingStats* stats){ timings = stats; };
+		TimingStats* getTimingStats(){ return timings; };
+		// Everything step() changes apart from memory contents, as a flat
+		// vector: link values, component state and the pipeline tracking.
+		void saveState(std::vector<luint>& state);
+		void loadState(const std::vector<luint>& state);
+		// Make this model a copy of other's program, breakpoints, simulation
+		// state and history, so it carries on exactly as other would.
+		void copySimulation(Model& other);
+		void takeSnapshot(ModelSnapshot& snapshot);
+		// Show a snapshot taken from a copy. History is left as it is.
+		void loadSnapshot(const ModelSnapshot& snapshot);
+		Layout getLayout(){ return layout; };
+		luint run(luint maxCycles);
+		// Run until the program has run off its end, as atEnd() finds it,
+		// or for maxCycles clock cycles. Returns the number of clock cycles.
+		luint runToEnd(luint end, luint maxCycles);
+		// True once the program has run past end. The single cycle layout
+		// checks for a cycle that fetches from end or beyond, which a branch
+		// past the last instruction reaches without passing end. The
+		// pipelined layouts fetch past end before earlier branches resolve,
+		// so they also wait for every instruction before end to leave.
+		bool atEnd(luint end);
+		bool atBreakpoint();
+		void toggleBreakpoint(luint address);
+		bool isBreakpoint(luint address){ return breakpoints.count(address) != 0; };
+		void clearBreakpoints(){ breakpoints.clear(); };
 		void reset();
-		void draw(wxPoint mousePos, double scale);
+		void draw(Renderer& renderer, wxPoint mousePos, double scale);
 		void addVertex(wxPoint mousePos);
 		Component* findComponent(wxPoint mousePos);
 		Link* findLink(wxPoint mousePos);
+		// Smallest rectangle holding every component and connection.
+		void getLayoutBounds(Coord& min, Coord& max);
 		luint getMemoryData(uint mem, luint address);
 		void setMemoryData(uint mem, luint address, luint data);
 		void getFieldedInstruction(luint address, wxString & str);
@@ -83,18 +161,55 @@ class Model
 		luint getCurrentInstruction();
 		void setHighlightInstruction(luint instr, bool valid = true);
 		wxColour getColourForInstruction(uint loc);
+		// Addresses of the instructions highlighted as being in the datapath:
+		// the PC, or one per pipeline stage.
+		void getPipelineAddresses(std::vector<luint>& addresses);
+		void setSimulationMode(SimulationMode mode);
+		SimulationMode getSimulationMode(){ return simulationMode; };
+		// Number of component steps taken by the last call to step().
+		uint getEvaluationsPerStep(){ return evaluations; };
 		static const luint MAX_MEM_VAL = (((luint)1)<<32) - 1;
+		static const luint NO_STOP_ADDRESS = MAX_MEM_VAL + 1;
+		static const luint NO_ADDRESS = MAX_MEM_VAL + 1;	// An empty or flushed pipeline stage.
 		static const uint MAX_INSTRUCTIONS = 512;
 		static const uint MAX_REGISTERS = 32;
 		static const uint MAX_DATA = 512;
-		static void setBool(configName name, bool newBool){ bools[name] = newBool; };
-		static bool getBool(configName name){ return bools[name]; };
+		// Forward jumps are stepped on the caller's thread, so keep them short.
+		static const luint MAX_JUMP_AHEAD = 10000;
+		void setBool(configName name, bool newBool){ bools[name] = newBool; };
+		bool getBool(configName name){ return bools[name]; };
+		void setColour(configName name, wxColour colour);
+		void setAreDataLinesBold(bool val = true);
+		void setHighlightSingleInstruction(bool val = true);
+		void setDetailLevel(DetailLevel level);
+		DetailLevel getDetailLevel();
 	private:
+		bool stepComponents(bool pipelined);
+		void resetStageAddresses(luint fetched);
+		// Rebuild the hit-testing grids. Needed whenever a component moves.
+		void buildSpatialIndex();
+	  	std::unique_ptr<ComponentContext> context;
 	  	std::list<std::shared_ptr<Component>> components;
+	  	std::unique_ptr<Netlist> netlist;
+	  	SpatialIndex componentIndex;
+	  	std::vector<Component*> indexedComponents;
+	  	SpatialIndex linkIndex;
+	  	std::vector<Link*> indexedLinks;
+	  	SimulationMode simulationMode;
+	  	uint evaluations;
+	  	luint cycle;
+	  	History history;
+	  	PerformanceCounters counters;
+	  	TimingStats* timings;
+	  	std::vector<luint> historyState;	// State after the latest step, if historyStateValid.
+	  	std::vector<luint> nextState;
+	  	bool historyStateValid;
+	  	std::vector<MemoryWrite> memoryWrites; // Memory changes made by the latest step or step back.
 		std::map<uint, std::shared_ptr<Memory>> memories;
 	  	std::array<std::shared_ptr<PipelineRegister>, 4> buffers;
 	  	std::shared_ptr<PC> programCounter;
 	  	std::shared_ptr<AndGate> branchCheckGate;
+	  	std::shared_ptr<Forwarding> forwardingUnit;
 	  	bool creatingConnection;
 	  	bool movingComponent;
 	  	wxRealPoint movingDifference;
@@ -108,7 +223,11 @@ class Model
 	  	Symbol currInstr[5];
 	  	luint currAddr[5];
 	  	uint lastAddrLoc;
-	  	static std::map<configName, bool> bools;
+	  	// Address of the instruction in each stage, fetch first. Unlike
+	  	// currAddr, flushed instructions are removed.
+	  	luint stageAddrs[5];
+	  	std::set<luint> breakpoints;
+	  	std::map<configName, bool> bools;
 };
 
 #endif /*MODEL_H_*/
@@ -0,0 +1,197 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include "Component.h"
+#include "Link.h"
+
+#include "Netlist.h"
+
+Netlist::Netlist(const std::list<std::shared_ptr<Component>>& components)
+{
+	// Give every link a slot in the value array. Slot 0 is kept at zero for
+	// inputs that are driven by a node with nothing connected to it.
+	std::map<Link*, uint> index;
+	uint numValues = 1;
+	for(auto&& comp : components)
+	{
+		for(auto&& i : comp->linkList)
+		{
+			index[i.second.get()] = numValues++;
+		}
+	}
+	values.assign(numValues, 0);
+	for(auto&& i : index)
+	{
+		i.first->bindValue(&values[i.second]);
+	}
+
+	std::vector<std::pair<Component*, uint>> bases;
+	for(auto&& comp : components)
+	{
+		activity.push_back(std::make_pair(comp.get(), resolveActivity(comp.get(), components.size())));
+		if(comp->getType() == NODE_TYPE)
+		{
+			continue;
+		}
+		schedule.push_back(comp.get());
+		uint base = ports.size();
+		bases.push_back(std::make_pair(comp.get(), base));
+		ports.resize(base + (comp->linkList.empty() ? 0 : comp->linkList.rbegin()->first + 1));
+		for(auto&& i : comp->linkList)
+		{
+			NetPort& port = ports[base + i.first];
+			Link* link = i.second.get();
+			port.value = index[link];
+			port.driver = port.value;
+			if(!(link->isOutput()))
+			{
+				InputLink* iLink = static_cast<InputLink*>(link);
+				port.input = true;
+				port.shift = iLink->getStartBit();
+				port.mask = iLink->getBitLength() < 64 ? (((luint)(1)<<iLink->getBitLength()) - 1) : ~(luint)0;
+				if(iLink->isConnected())
+				{
+					port.driver = resolveDriver(iLink, index);
+					port.source = resolveActivity(iLink->getOutput()->getComp(), components.size());
+					transfers.push_back(std::make_pair(port.value, port.driver));
+				}
+				else
+				{
+					port.link = iLink;
+				}
+			}
+		}
+	}
+	for(auto&& i : bases)
+	{
+		Component* comp = i.first;
+		comp->netValues = values.data();
+		comp->netPorts = ports.data() + i.second;
+		comp->numNetPorts = comp->linkList.empty() ? 0 : comp->linkList.rbegin()->first + 1;
+	}
+}
+
+uint Netlist::resolveDriver(InputLink* link, const std::map<Link*, uint>& index)
+{
+	// Follow the same path as OutputLink::getVal() and Node::getVal().
+	OutputLink* oLink = link->getOutput();
+	for(uint hops = 0; hops <= index.size(); hops++)
+	{
+		Component* comp = oLink->getComp();
+		if(comp->getType() != NODE_TYPE)
+		{
+			return index.at(oLink);
+		}
+		InputLink* next = 0;
+		for(auto&& i : comp->linkList)
+		{
+			Link* nodeLink = i.second.get();
+			if(!(nodeLink->isOutput()) && nodeLink->isConnected())
+			{
+				next = static_cast<InputLink*>(nodeLink);
+				break;
+			}
+		}
+		if(next == 0)
+		{
+			return 0;
+		}
+		oLink = next->getOutput();
+	}
+	return 0;
+}
+
+Component* Netlist::resolveActivity(Component* comp, uint maxHops)
+{
+	// Follow the same path as Node::isActive().
+	for(uint hops = 0; comp != 0 && hops <= maxHops; hops++)
+	{
+		if(comp->getType() != NODE_TYPE)
+		{
+			return comp;
+		}
+		Component* next = 0;
+		for(auto&& i : comp->linkList)
+		{
+			Link* nodeLink = i.second.get();
+			if(!(nodeLink->isOutput()) && nodeLink->isConnected())
+			{
+				Component* prev = static_cast<InputLink*>(nodeLink)->getOutput()->getComp();
+				if(prev->getID() != comp->getID())
+				{
+					next = prev;
+					break;
+				}
+			}
+		}
+		comp = next;
+	}
+	return 0;
+}
+
+bool Netlist::step(bool pipelined)
+{
+	// Update outputs based on inputs.
+	for(auto comp : schedule)
+	{
+		comp->evaluate();
+	}
+	// Update inputs from the outputs that drive them.
+	for(auto& i : transfers)
+	{
+		values[i.first] = values[i.second];
+	}
+	bool reset = false;
+	if(pipelined)
+	{
+		// Every component is set active again at the end of a pipelined
+		// sub-step, so the link colour darkening would be thrown away.
+		for(auto comp : schedule)
+		{
+			comp->activeOutputs = comp->preActive;
+			comp->preActive = true;
+		}
+		for(auto& i : activity)
+		{
+			i.first->oldActiveLinkColor = 1.0;
+		}
+	}
+	else
+	{
+		for(auto& i : activity)
+		{
+			if(i.second != 0 && i.second->activeOutputs)
+			{
+				i.first->oldActiveLinkColor = 0.7F;
+			}
+		}
+		for(auto comp : schedule)
+		{
+			comp->activeOutputs = comp->preActive;
+			if(comp->getType() == PC_TYPE && comp->allPortsActive())
+			{
+				reset = true;
+			}
+		}
+	}
+	return reset;
+}
@@ -0,0 +1,76 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef NETLIST_H_
+#define NETLIST_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+#include <utility>
+
+#include "Types.h"
+
+class Component;
+class Link;
+class InputLink;
+
+// One link slot of a component as seen by the compiled evaluator.
+struct NetPort
+{
+	NetPort() : value(0), driver(0), shift(0), mask(~(luint)0), input(false), source(0), link(0){};
+	uint value;         // Index of the link's value in the netlist value array.
+	uint driver;        // Index of the output value feeding this input.
+	uint shift;         // Bit field of the value the component reads.
+	luint mask;
+	bool input;
+	Component* source;  // Non node component whose activity this input follows.
+	Link* link;         // Unconnected input whose own activity flag is used.
+};
+
+// Flattened form of the component graph. All link values live in one dense
+// array, node chains are resolved to direct value copies and the components
+// are evaluated from a flat schedule, so a clock sub-step does not touch the
+// link maps at all.
+class Netlist
+{
+	public:
+		Netlist(const std::list<std::shared_ptr<Component>>& components);
+		// Run one clock sub-step, as Model::stepComponents(). Returns true if
+		// all inputs of the PC are active (used to restart the simple layout).
+		bool step(bool pipelined);
+		uint getNumValues(){ return values.size(); };
+		uint getNumComponents(){ return schedule.size(); };
+		// Values of every link, in a fixed order for the lifetime of the netlist.
+		std::vector<luint>& getValues(){ return values; };
+	private:
+		uint resolveDriver(InputLink* link, const std::map<Link*, uint>& index);
+		Component* resolveActivity(Component* comp, uint maxHops);
+		std::vector<luint> values;
+		std::vector<NetPort> ports;
+		std::vector<std::pair<uint, uint>> transfers; // Destination and source value indices.
+		std::vector<Component*> schedule;             // Non node components in evaluation order.
+		std::vector<std::pair<Component*, Component*>> activity; // Component and the component it shows activity of.
+};
+
+#endif /*NETLIST_H_*/
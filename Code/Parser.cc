@@ -21,12 +21,15 @@
  */
  
 #include "Scanner.h"
+#include "ProgramImage.h"
 
 #include "Parser.h"
 
 Parser::Parser(Scanner *smz)
 {
 	this->smz = smz;
+	errortotal = 0;
+	fromImage = false;
 	
 	opcodes[SYM_LW] = 35;
 	opcodes[SYM_SW] = 43;
@@ -75,27 +78,18 @@ Parser::Parser(Scanner *smz)
 
 bool Parser::parse(wxString & str)
 {
-	curSymbol = SYM_MIN;
-	errortotal = 0;
-	address = 0;
 	if(str != _T(""))
 	{
 		fileContents = str;
 		smz->setFileContents(str);
+		fromImage = false;
 	}
-	
-	// Clear temporary instruction store.
-	instructions.clear();
-	formattedInstructions.clear();
-	instructionSymbols.clear();
-	errors.clear();
-	smz->getChar();
-
-	do
+	else if(fromImage)
 	{
-		readInstruction();
+		// The image was assembled when it was saved.
+		return errortotal == 0;
 	}
-	while(curSymbol != SYM_EOF && curSymbol != SYM_DATA);
+	readInstructions();
 	
 	if(curSymbol != SYM_DATA)
 	{
@@ -158,6 +152,101 @@ void Parser::readMemory(luint address)
 	}
 }
 
+bool Parser::parseInstructions(wxString & str)
+{
+	smz->setFileContents(str);
+	fromImage = false;
+	readInstructions();
+	return errortotal == 0 && curSymbol != SYM_DATA;
+}
+
+void Parser::readInstructions()
+{
+	curSymbol = SYM_MIN;
+	errortotal = 0;
+	address = 0;
+	
+	// Clear temporary instruction store.
+	instructions.clear();
+	formattedInstructions.clear();
+	instructionSymbols.clear();
+	errors.clear();
+	smz->getChar();
+
+	do
+	{
+		readCachedInstruction();
+	}
+	while(curSymbol != SYM_EOF && curSymbol != SYM_DATA);
+}
+
+// Assemble the line at the scanner, or repeat what assembling the same
+// text gave before. Each line is one instruction, so its result does not
+// depend on the lines around it.
+void Parser::readCachedInstruction()
+{
+	wxString line;
+	if(!smz->getCurrentLine(line))
+	{
+		readInstruction();
+		return;
+	}
+	auto cached = lineCache.find(line);
+	if(cached != lineCache.end())
+	{
+		const parsedLine& parsed = cached->second;
+		if(parsed.hasInstruction)
+		{
+			if(parsed.hasWord)
+			{
+				instructions[address] = parsed.word;
+			}
+			if(parsed.hasSymbol)
+			{
+				instructionSymbols[address] = parsed.symbol;
+			}
+			formattedInstructions[address] = parsed.formatted;
+			address += 4;
+		}
+		for(auto&& i : parsed.errors)
+		{
+			errors[errortotal] = i;
+			errortotal++;
+		}
+		smz->skipLine();
+		curSymbol = SYM_EOL;
+		return;
+	}
+	
+	luint lineAddress = address;
+	int lineErrors = errortotal;
+	readInstruction();
+	if(curSymbol == SYM_DATA)
+	{
+		// The data section is read straight from the scanner.
+		return;
+	}
+	if(lineCache.size() >= MAX_CACHED_LINES)
+	{
+		lineCache.clear();
+	}
+	parsedLine& parsed = lineCache[line];
+	parsed.hasInstruction = (address != lineAddress);
+	parsed.hasWord = parsed.hasInstruction && instructions.count(lineAddress) != 0;
+	parsed.hasSymbol = parsed.hasInstruction && instructionSymbols.count(lineAddress) != 0;
+	parsed.word = parsed.hasWord ? instructions[lineAddress] : 0;
+	parsed.symbol = parsed.hasSymbol ? instructionSymbols[lineAddress] : SYM_BAD;
+	if(parsed.hasInstruction)
+	{
+		parsed.formatted = formattedInstructions[lineAddress];
+	}
+	parsed.errors.clear();
+	for(int i = lineErrors; i < errortotal; i++)
+	{
+		parsed.errors.push_back(errors[i]);
+	}
+}
+
 bool Parser::readIn()
 {
 	// Take contents of file and store in fileContents string.
@@ -206,7 +295,9 @@ void Parser::getMemString(luint address, wxString & str)
 
 luint Parser::getMemData(luint address)
 {
-	return initialMemData[address];
+	// Reading must not grow the map, the memory editor reads every row.
+	auto data = initialMemData.find(address);
+	return (data == initialMemData.end()) ? 0 : data->second;
 }
 
 void Parser::setMemData(luint address, luint data)
@@ -456,3 +547,96 @@ void Parser::invalidInput(ParseError err)
 	instrErrors++;
 }
 
+void Parser::saveImage(ProgramImage& image, luint numInstructions, luint numData)
+{
+	image.instructions.assign(numInstructions, ProgramImage::Instruction());
+	image.text.clear();
+	for(luint i = 0; i < numInstructions; i++)
+	{
+		ProgramImage::Instruction& instr = image.instructions[i];
+		luint address = i * 4;
+		auto word = instructions.find(address);
+		if(word != instructions.end())
+		{
+			instr.word = word->second;
+			instr.flags |= ProgramImage::HAS_WORD;
+		}
+		auto symbol = instructionSymbols.find(address);
+		if(symbol != instructionSymbols.end())
+		{
+			instr.symbol = symbol->second;
+			instr.flags |= ProgramImage::HAS_SYMBOL;
+		}
+		auto line = formattedInstructions.find(address);
+		if(line != formattedInstructions.end())
+		{
+			instr.flags |= ProgramImage::HAS_LINE | (line->second.err ? ProgramImage::LINE_ERROR : 0);
+			image.text += std::string(line->second.str.utf8_str());
+		}
+		instr.textEnd = image.text.size();
+	}
+	image.data.resize(numData);
+	for(luint i = 0; i < numData; i++)
+	{
+		image.data[i] = getMemData(i);
+	}
+	image.errors.resize(errortotal);
+	for(int i = 0; i < errortotal; i++)
+	{
+		image.errors[i] = errors[i];
+	}
+}
+
+bool Parser::loadImage(const ProgramImage& image)
+{
+	instructions.clear();
+	formattedInstructions.clear();
+	instructionSymbols.clear();
+	initialMemData.clear();
+	errors.clear();
+	fileContents.Clear();
+	errortotal = 0;
+	uint32_t textStart = 0;
+	for(size_t i = 0; i < image.instructions.size(); i++)
+	{
+		const ProgramImage::Instruction& instr = image.instructions[i];
+		luint address = i * 4;
+		if(instr.flags & ProgramImage::HAS_WORD)
+		{
+			instructions[address] = instr.word;
+		}
+		if(instr.flags & ProgramImage::HAS_SYMBOL)
+		{
+			if(instr.symbol >= SYM_MAX)
+			{
+				return false;
+			}
+			instructionSymbols[address] = (Symbol)instr.symbol;
+		}
+		if(instr.flags & ProgramImage::HAS_LINE)
+		{
+			formattedInstructions[address].str = wxString::FromUTF8(image.text.data() + textStart, instr.textEnd - textStart);
+			formattedInstructions[address].err = !!(instr.flags & ProgramImage::LINE_ERROR);
+		}
+		textStart = instr.textEnd;
+	}
+	for(size_t i = 0; i < image.data.size(); i++)
+	{
+		if(image.data[i] != 0)
+		{
+			initialMemData[i] = image.data[i];
+		}
+	}
+	for(auto&& i : image.errors)
+	{
+		if(i >= ERR_MAX)
+		{
+			return false;
+		}
+		errors[errortotal] = (ParseError)i;
+		errortotal++;
+	}
+	address = image.instructions.size() * 4;
+	fromImage = true;
+	return true;
+}
@@ -51,11 +51,16 @@ enum ParseError
 	ERR_MAX,
 };
 
+class ProgramImage;
+
 class Parser
 {
 public:
 	Parser(Scanner *smz);
 	bool parse(wxString & str);
+	// Assemble str, which has no data section, leaving the memory data as
+	// it is. Returns false if it has errors or a data section.
+	bool parseInstructions(wxString & str);
 	bool readIn();
 	void printInstructions();
 	luint getInstruction(luint address);
@@ -67,11 +72,31 @@ public:
 	void setMemData(luint address, luint data);
 	void getFileContents(wxString & str);
 	Symbol getInstructionSymbol(luint address);
+	// Copy the first numInstructions instructions, numData data words and
+	// the errors into image.
+	void saveImage(ProgramImage& image, luint numInstructions, luint numData);
+	// Replace everything parsed with the contents of image, which then
+	// stands in for the file until other text is parsed. Returns false if
+	// image holds symbols or errors this parser does not know.
+	bool loadImage(const ProgramImage& image);
 private:
 	struct instruction {
 		wxString str;
 		bool err;
 	};
+	// What assembling one line of the instruction section gave, so that a
+	// line is only assembled again when its text changes.
+	struct parsedLine {
+		bool hasInstruction;	// The line took an address.
+		bool hasWord;			// It assembled without errors.
+		bool hasSymbol;
+		luint word;
+		Symbol symbol;
+		instruction formatted;
+		std::vector<ParseError> errors;
+	};
+	void readInstructions();
+	void readCachedInstruction();
 	void readMemory(luint address);
 	void readInstruction();
 	void readLoadStoreInstruction();
@@ -99,9 +124,12 @@ private:
 	std::map<luint, instruction> formattedInstructions;
 	std::map<luint, Symbol> instructionSymbols;
 	std::map<luint, luint> initialMemData;
+	std::map<wxString, parsedLine> lineCache;	// Keyed by line text.
 	wxString fileContents;
+	bool fromImage;			// Parsed state came from loadImage().
 	std::map<int, ParseError> errors;
 	std::map<ParseError, wxString> errorStrings;
+	static const uint MAX_CACHED_LINES = 1024;
 	static const luint OP_OFFSET = 1<<26;
 	static const luint RS_OFFSET = 1<<21;
 	static const luint RT_OFFSET = 1<<16;
@@ -0,0 +1,140 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include "PerformanceCounters.h"
+
+PerformanceCounters::PerformanceCounters()
+{
+	reset();
+}
+
+void PerformanceCounters::reset(Symbol fetched)
+{
+	for(uint i = COUNTER_MIN; i < COUNTER_MAX; i++)
+	{
+		counts[i] = 0;
+	}
+	for(uint i = 0; i < MAX_DEPTH; i++)
+	{
+		stages[i] = SYM_BAD;
+	}
+	stages[0] = fetched;
+}
+
+void PerformanceCounters::addCycle(uint depth, Symbol fetched, bool flushed, bool forwardA, bool forwardB)
+{
+	counts[COUNTER_CYCLES]++;
+	if(flushed)
+	{
+		counts[COUNTER_FLUSHES]++;
+		// IF/ID held the instruction fetched last cycle.
+		if(depth > 1 && stages[0] != SYM_BAD)
+		{
+			stages[0] = SYM_NOOP;
+		}
+	}
+	if(forwardA)
+	{
+		counts[COUNTER_FORWARD_A]++;
+	}
+	if(forwardB)
+	{
+		counts[COUNTER_FORWARD_B]++;
+	}
+	Symbol leaving = stages[depth - 1];
+	if(leaving == SYM_NOOP)
+	{
+		counts[COUNTER_BUBBLES]++;
+	}
+	else if(leaving != SYM_BAD)
+	{
+		counts[COUNTER_RETIRED]++;
+	}
+	for(uint i = depth - 1; i > 0; i--)
+	{
+		stages[i] = stages[i - 1];
+	}
+	stages[0] = fetched;
+}
+
+const char* PerformanceCounters::getName(Counter counter)
+{
+	switch(counter)
+	{
+		case COUNTER_CYCLES:
+			return "cycles";
+		case COUNTER_RETIRED:
+			return "retired";
+		case COUNTER_FLUSHES:
+			return "flushes";
+		case COUNTER_FORWARD_A:
+			return "forward_a";
+		case COUNTER_FORWARD_B:
+			return "forward_b";
+		case COUNTER_BUBBLES:
+			return "bubbles";
+		default:
+			return "";
+	}
+}
+
+void PerformanceCounters::saveState(std::vector<luint>& state)
+{
+	state.insert(state.end(), counts, counts + COUNTER_MAX);
+	state.insert(state.end(), stages, stages + MAX_DEPTH);
+}
+
+void PerformanceCounters::loadState(const luint*& state)
+{
+	for(uint i = COUNTER_MIN; i < COUNTER_MAX; i++)
+	{
+		counts[i] = *state++;
+	}
+	for(uint i = 0; i < MAX_DEPTH; i++)
+	{
+		stages[i] = (Symbol)*state++;
+	}
+}
+
+void PerformanceCounters::writeCSV(std::ostream& out)
+{
+	for(uint i = COUNTER_MIN; i < COUNTER_MAX; i++)
+	{
+		out << getName((Counter)i) << ",";
+	}
+	out << "cpi\n";
+	for(uint i = COUNTER_MIN; i < COUNTER_MAX; i++)
+	{
+		out << counts[i] << ",";
+	}
+	out << getCPI() << "\n";
+}
+
+void PerformanceCounters::writeJSON(std::ostream& out)
+{
+	out << "{\n";
+	for(uint i = COUNTER_MIN; i < COUNTER_MAX; i++)
+	{
+		out << "\t\"" << getName((Counter)i) << "\": " << counts[i] << ",\n";
+	}
+	out << "\t\"cpi\": " << getCPI() << "\n}\n";
+}
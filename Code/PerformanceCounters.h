@@ -0,0 +1,71 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef PERFORMANCECOUNTERS_H_
+#define PERFORMANCECOUNTERS_H_
+
+#include <ostream>
+#include <vector>
+
+#include "Types.h"
+#include "Enums.h"
+
+enum Counter
+{
+	COUNTER_MIN = 0,
+	COUNTER_CYCLES = 0,
+	COUNTER_RETIRED,	// Instructions that completed write back.
+	COUNTER_FLUSHES,	// Taken branches that emptied IF/ID.
+	COUNTER_FORWARD_A,	// Cycles the forwarding unit selected a forwarded ALU input A.
+	COUNTER_FORWARD_B,
+	COUNTER_BUBBLES,	// NOPs and flushed instructions that reached write back.
+	COUNTER_MAX
+};
+
+// Cycle and instruction counts for a run, kept by Model::step(). The
+// counters follow each instruction down the pipeline, so an instruction
+// counts as retired (or as a bubble) once it leaves write back.
+class PerformanceCounters
+{
+	public:
+		PerformanceCounters();
+		// Clear the counts, with fetched as the instruction now in IF.
+		void reset(Symbol fetched = SYM_BAD);
+		// Record a finished clock cycle of a datapath depth stages long
+		// (1 for the single cycle layout). fetched is the instruction that
+		// enters IF next.
+		void addCycle(uint depth, Symbol fetched, bool flushed, bool forwardA, bool forwardB);
+		luint get(Counter counter){ return counts[counter]; };
+		double getCPI(){ return counts[COUNTER_RETIRED] ? (double)counts[COUNTER_CYCLES] / counts[COUNTER_RETIRED] : 0; };
+		// Short name used as the column or key when exporting.
+		static const char* getName(Counter counter);
+		void saveState(std::vector<luint>& state);
+		void loadState(const luint*& state);
+		void writeCSV(std::ostream& out);
+		void writeJSON(std::ostream& out);
+		static const uint MAX_DEPTH = 5;
+	private:
+		luint counts[COUNTER_MAX];
+		Symbol stages[MAX_DEPTH];	// Instruction in each stage, SYM_BAD when empty.
+};
+
+#endif /*PERFORMANCECOUNTERS_H_*/
@@ -0,0 +1,103 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <cstring>
+#include <fstream>
+
+#include "MappedFile.h"
+
+#include "ProgramImage.h"
+
+const char ProgramImage::MAGIC[8] = { 'M', 'I', 'P', 'S', 'I', 'M', 'G', 0 };
+
+bool ProgramImage::read(wxString file)
+{
+	static_assert(sizeof(Instruction) == 12, "Instruction is saved as it is laid out");
+	MappedFile mapping;
+	if(!mapping.open(file) || mapping.getSize() < sizeof(Header))
+	{
+		return false;
+	}
+	const char* bytes = mapping.getData();
+	Header header;
+	memcpy(&header, bytes, sizeof(Header));
+	if(memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.byteOrder != BYTE_ORDER_MARK)
+	{
+		return false;
+	}
+	// Counts are 32 bit, so these sums can not overflow.
+	uint64_t size = sizeof(Header) + (uint64_t)header.numInstructions * sizeof(Instruction)
+		+ (uint64_t)header.numData * sizeof(uint32_t) + (uint64_t)header.numErrors * sizeof(uint32_t)
+		+ header.textBytes;
+	if(size != mapping.getSize())
+	{
+		return false;
+	}
+	bytes += sizeof(Header);
+	instructions.resize(header.numInstructions);
+	memcpy(instructions.data(), bytes, header.numInstructions * sizeof(Instruction));
+	bytes += header.numInstructions * sizeof(Instruction);
+	data.resize(header.numData);
+	memcpy(data.data(), bytes, header.numData * sizeof(uint32_t));
+	bytes += header.numData * sizeof(uint32_t);
+	errors.resize(header.numErrors);
+	memcpy(errors.data(), bytes, header.numErrors * sizeof(uint32_t));
+	bytes += header.numErrors * sizeof(uint32_t);
+	text.assign(bytes, header.textBytes);
+
+	// Lines must follow each other within the text.
+	uint32_t textEnd = 0;
+	for(auto&& i : instructions)
+	{
+		if(i.textEnd < textEnd || i.textEnd > header.textBytes)
+		{
+			return false;
+		}
+		textEnd = i.textEnd;
+	}
+	return true;
+}
+
+bool ProgramImage::write(wxString file)
+{
+	Header header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.byteOrder = BYTE_ORDER_MARK;
+	header.numInstructions = instructions.size();
+	header.numData = data.size();
+	header.numErrors = errors.size();
+	header.textBytes = text.size();
+	std::ofstream out(file.fn_str(), std::ios::binary);
+	out.write((const char*)&header, sizeof(Header));
+	out.write((const char*)instructions.data(), instructions.size() * sizeof(Instruction));
+	out.write((const char*)data.data(), data.size() * sizeof(uint32_t));
+	out.write((const char*)errors.data(), errors.size() * sizeof(uint32_t));
+	out.write(text.data(), text.size());
+	out.close();
+	return !out.fail();
+}
+
+bool ProgramImage::isImageFile(wxString file)
+{
+	return file.Lower().EndsWith(_T(".mipsimg"));
+}
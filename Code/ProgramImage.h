@@ -0,0 +1,80 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef PROGRAMIMAGE_H_
+#define PROGRAMIMAGE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+// An assembled program saved in binary (.mipsimg), so that loading it is a
+// copy of each section rather than scanning and parsing text. A file is a
+// Header followed by the instructions, the data words, the error codes and
+// finally the formatted instruction lines as UTF-8, all in the byte order
+// of the machine that wrote it.
+class ProgramImage
+{
+	public:
+		// One instruction address.
+		struct Instruction
+		{
+			uint32_t word;
+			uint8_t symbol;
+			uint8_t flags;
+			uint16_t padding;
+			uint32_t textEnd;	// End of this address's line in text.
+		};
+		enum
+		{
+			HAS_WORD = 1,
+			HAS_SYMBOL = 2,
+			HAS_LINE = 4,
+			LINE_ERROR = 8
+		};
+		// Returns false if file is not a complete image of this version.
+		bool read(wxString file);
+		bool write(wxString file);
+		static bool isImageFile(wxString file);
+		static const uint32_t VERSION = 1;
+		std::vector<Instruction> instructions;
+		std::vector<uint32_t> data;
+		std::vector<uint32_t> errors;
+		std::string text;
+	private:
+		struct Header
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t byteOrder;		// BYTE_ORDER_MARK as written.
+			uint32_t numInstructions;
+			uint32_t numData;
+			uint32_t numErrors;
+			uint32_t textBytes;
+		};
+		static const char MAGIC[8];
+		static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+};
+
+#endif /*PROGRAMIMAGE_H_*/
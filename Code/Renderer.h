@@ -0,0 +1,62 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef RENDERER_H_
+#define RENDERER_H_
+
+#include <wx/string.h>
+
+#include "Color.h"
+
+enum PrimitiveType
+{
+	PRIMITIVE_TRIANGLES,
+	PRIMITIVE_TRIANGLE_STRIP,
+	PRIMITIVE_POLYGON,
+	PRIMITIVE_LINE_STRIP,
+	PRIMITIVE_LINE_LOOP
+};
+
+// Drawing interface used by the model and components. The simulation core
+// only draws through this, so it can be built and run without a display.
+class Renderer
+{
+	public:
+		virtual ~Renderer(){};
+		// Save / restore the transform, colour, line width and smoothing.
+		virtual void pushState() = 0;
+		virtual void popState() = 0;
+		virtual void translate(double x, double y) = 0;
+		virtual void scale(double x, double y) = 0;
+		virtual void rotate(double degrees) = 0;
+		virtual void setColour(const Color& colour) = 0;
+		virtual void setLineWidth(float width) = 0;
+		virtual void setPolygonSmooth(bool smooth) = 0;
+		virtual void begin(PrimitiveType type) = 0;
+		virtual void vertex(double x, double y) = 0;
+		virtual void end() = 0;
+		// Draw a single line of text with its baseline starting at (x, y).
+		// zoom is the current view scale, used to choose the font size.
+		virtual void drawText(double x, double y, const wxString& text, double zoom) = 0;
+};
+
+#endif /*RENDERER_H_*/
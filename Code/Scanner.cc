@@ -20,6 +20,8 @@
  * 
  */
  
+#include <cstring>
+
 #include "Scanner.h"
 
 // Public Methods
@@ -38,18 +40,18 @@ Scanner::Scanner(wxString defname)
 	names["beq"] = SYM_BEQ;
 	names["nop"] = SYM_NOOP;
 	
+	setText("", 0);
+	curch = 0;
 	if(defname != _T(""))
 	{	
-	  	deffile.open(defname.fn_str());
-	  	  	
-	  	if (!deffile) 
-	    {
-	      	std::cout << "File Error" << std::endl;
-	    }
-	  	else 
-	    {
-	      	getChar(true);
-	    }
+		if(!deffile.open(defname))
+		{
+			std::cout << "File Error" << std::endl;
+		}
+		else
+		{
+			setText(deffile.getData(), deffile.getSize());
+		}
 	}
 }
 
@@ -59,30 +61,19 @@ Scanner::~Scanner()
 
 void Scanner::getFileContents(wxString & str)
 {
-	deffile.seekg(0);
-	str.Clear();
-	while(eofile == false)
-	{
-		getChar(true);
-		str += curch;
-	}
-	// store contents locally
-	// set position to 0.
-	contents = str;
-	pos = 0;
-	eofile = false;
+	setText(deffile.getData(), deffile.getSize());
+	str = wxString(text, wxConvLibc, length);
 }
 
 void Scanner::setFileContents(wxString & str)
 {
-	contents = str;
-	pos = 0;
-	eofile = false;
+	ownContents = (const char*)str.mb_str();
+	setText(ownContents.data(), ownContents.size());
 }
 
 void Scanner::getLine(wxString & line)
 {
-	line = lastLine;
+	line = wxString(text + lastLineStart, wxConvLibc, lastLineEnd - lastLineStart);
 }
 
 void Scanner::getSymbol(Symbol & s, int & num)
@@ -98,8 +89,9 @@ void Scanner::getSymbol(Symbol & s, int & num)
 	 	else if(curch == '\n') 
 	    {
 	      	s = SYM_EOL;
-	      	lastLine = curLine;
-	      	curLine = _T("");
+	      	lastLineStart = lineStart;
+	      	lastLineEnd = pos;
+	      	lineStart = pos;
 	      	getChar();
 	    }
 	  	else if(isdigit(curch) || curch == '-')
@@ -142,42 +134,61 @@ void Scanner::getSymbol(Symbol & s, int & num)
     }
 }
 
-void Scanner::unget()
-{
-	deffile.unget();
-}
-
-// Gets the next character from the definition file
-// If character is '\n' (end of line), sets eoline to true to keep current character position correct
-void Scanner::getChar(bool fromFile)
+// Gets the next character from the text.
+void Scanner::getChar()
 {
-	if(fromFile)
+	if(pos < length)
 	{
-	  	eofile = deffile.get(curch).eof();
+		curch = text[pos];
+		pos++;
 	}
 	else
 	{
-		if(pos < contents.Len())
-		{
-			curch = contents.GetChar(pos);
-			pos++;
-			curLine += curch;
-		}
-		else
-		{
-			eofile = true;
-			curch = 0;
-		}
+		eofile = true;
+		curch = 0;
+	}
+}
+
+bool Scanner::getCurrentLine(wxString & line)
+{
+	const char* end = (const char*)memchr(text + lineStart, '\n', length - lineStart);
+	if(end == 0)
+	{
+		return false;
 	}
+	line = wxString(text + lineStart, wxConvLibc, end - text + 1 - lineStart);
+	return true;
+}
+
+void Scanner::skipLine()
+{
+	const char* end = (const char*)memchr(text + lineStart, '\n', length - lineStart);
+	pos = end - text + 1;
+	lastLineStart = lineStart;
+	lastLineEnd = pos;
+	lineStart = pos;
+	getChar();
 }
 
 bool Scanner::checkFile()
 {
-	return deffile.good();
+	return deffile.isOpen() && deffile.getSize() != 0;
 }
 
 // Private Methods
 
+// Start scanning text from the beginning.
+void Scanner::setText(const char* text, size_t length)
+{
+	this->text = text;
+	this->length = length;
+	pos = 0;
+	lineStart = 0;
+	lastLineStart = 0;
+	lastLineEnd = 0;
+	eofile = false;
+}
+
 // Continues getting characters from the definition file until non-space found
 void Scanner::skipSpaces()
 {
@@ -200,7 +211,7 @@ void Scanner::getNumber(int &num)
   	
   	while ( (!eofile) && (!isdigit(curch)==0) )
     { 
-      	num = 10 * num + atoi(&curch);
+      	num = 10 * num + (curch - '0');
       	getChar();
     }
     
@@ -23,7 +23,6 @@
 #ifndef SCANNER_H_
 #define SCANNER_H_
 
-#include <fstream>
 #include <string>
 #include <map>
 #include <iostream>
@@ -32,7 +31,11 @@
 
 #include "Enums.h"
 #include "Types.h"
+#include "MappedFile.h"
 
+// Splits a program into symbols. A file is scanned straight out of a
+// memory mapping, and lines are kept as offsets into the text, so loading
+// costs no copies or allocations per character.
 class Scanner
 {
 public:
@@ -43,18 +46,26 @@ public:
 	void getFileContents(wxString & str);
 	void setFileContents(wxString & str);
 	void getSymbol(Symbol & s, int & num);
-	void unget();
-	void getChar(bool fromFile = false);
+	void getChar();
+	// Text of the line being scanned, up to and including its end of line.
+	// Returns false if it has no end of line.
+	bool getCurrentLine(wxString & line);
+	// Move past the current line, as scanning its symbols would.
+	void skipLine();
 private:
+	void setText(const char* text, size_t length);
 	void skipSpaces();
 	void getNumber(int &num);
 	Symbol getName();
 	bool eofile;
-	uint pos;
-	wxString contents;
-	std::ifstream deffile;
+	MappedFile deffile;
+	std::string ownContents;	// Text set by setFileContents().
+	const char* text;			// Text being scanned, in deffile or ownContents.
+	size_t length;
+	size_t pos;
+	size_t lineStart;			// Offset of the start of the current line.
+	size_t lastLineStart, lastLineEnd;
 	char curch;
-	wxString curLine, lastLine;
 	std::map<std::string, Symbol> names;
 };
 
@@ -0,0 +1,324 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wx/filename.h>
+#include <wx/image.h>
+
+#include "Model.h"
+#include "Component.h"
+#include "Scanner.h"
+#include "SimulationWorker.h"
+#include "FrameExporter.h"
+#include "BatchRunner.h"
+
+#include "SelfTest.h"
+
+// Counts up in $1 for ever.
+const char* SelfTest::LOOP_PROGRAM =
+	"ADDI $1, $1, 1\n"
+	"SW $1, 0($0)\n"
+	"BEQ $0, $0, -3\n"
+	"Data:\n"
+	"0\n";
+
+// Runs off its end without a branch.
+const char* SelfTest::STRAIGHT_PROGRAM =
+	"ADDI $1, $0, 1\n"
+	"ADDI $2, $1, 2\n"
+	"SW $2, 0($0)\n"
+	"Data:\n"
+	"0\n";
+const luint SelfTest::STRAIGHT_LENGTH = 3;
+
+// Ends with a branch to beyond its last instruction, so the PC never holds
+// the address just after it.
+const char* SelfTest::TRAILING_BRANCH_PROGRAM =
+	"ADDI $1, $0, 5\n"
+	"BEQ $0, $0, 2\n"
+	"Data:\n"
+	"0\n";
+
+// Branches over one instruction in the middle.
+const char* SelfTest::FORWARD_BRANCH_PROGRAM =
+	"ADDI $1, $0, 1\n"
+	"BEQ $0, $0, 1\n"
+	"ADDI $2, $0, 2\n"
+	"ADDI $3, $0, 3\n"
+	"Data:\n"
+	"0\n";
+
+// Register numbers and offsets of one and two digits, and what they
+// assemble to.
+const char* SelfTest::REGISTERS_PROGRAM =
+	"LW $0, 0($0)\n"
+	"ADD $3, $1, $2\n"
+	"ADDI $31, $0, 17\n"
+	"SW $12, 8($4)\n"
+	"Data:\n"
+	"0\n";
+const luint SelfTest::REGISTERS_WORDS[] = { 0x8c000000, 0x00221820, 0x201f0011, 0xac8c0008 };
+
+bool SelfTest::run(std::ostream& out)
+{
+	bool passed = true;
+	passed = testWorkerRestart(out) && passed;
+	passed = testExport(out) && passed;
+	passed = testBatchEnd(out) && passed;
+	passed = testRepeatedLoad(out) && passed;
+	out << (passed ? "all tests passed\n" : "some tests failed\n");
+	return passed;
+}
+
+// Run the worker several times from one SimulationWorker. Each snapshot it
+// publishes, and the state it hands back, must match a model stepped
+// directly to the same cycle. A worker that reuses a slot the GUI is
+// reading shows up here as torn snapshots, or as a race under a thread
+// sanitizer.
+bool SelfTest::testWorkerRestart(std::ostream& out)
+{
+	wxString file = writeProgram(_T("selftest_loop"), LOOP_PROGRAM);
+	Model direct, shown;
+	direct.resetup(LAYOUT_PIPELINE);
+	shown.resetup(LAYOUT_PIPELINE);
+	if(!direct.loadProgram(file) || !shown.loadProgram(file))
+	{
+		out << "worker restart: program did not load\n";
+		return false;
+	}
+	SimulationWorker worker;
+	uint mismatches = 0;
+	for(uint run = 0; run < 4; run++)
+	{
+		// Runs of different lengths leave the slots in different orders.
+		worker.start(shown);
+		auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(40 + 25 * run);
+		bool last = false;
+		while(!last)
+		{
+			last = std::chrono::steady_clock::now() >= end;
+			if(last)
+			{
+				worker.stop(shown);
+			}
+			else if(!worker.update(shown))
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				continue;
+			}
+			while(direct.getCycle() < shown.getCycle())
+			{
+				direct.step();
+			}
+			std::vector<luint> expected, actual;
+			direct.saveState(expected);
+			shown.saveState(actual);
+			if(direct.getCycle() != shown.getCycle() || expected != actual || direct.getMemoryData(ID_DATA_LIST, 0) != shown.getMemoryData(ID_DATA_LIST, 0))
+			{
+				mismatches++;
+			}
+		}
+	}
+	wxRemoveFile(file);
+	if(mismatches != 0)
+	{
+		out << "worker restart: " << mismatches << " snapshots differ from the model stepped directly\n";
+		return false;
+	}
+	return true;
+}
+
+// Export a program with no branches in the simple layout. There is a frame
+// for the initial state and one after each clock step of each instruction,
+// and every PNG covers the layout and its border at the default scale.
+bool SelfTest::testExport(std::ostream& out)
+{
+	wxString file = writeProgram(_T("selftest_export"), STRAIGHT_PROGRAM);
+	Model model;
+	model.resetup(LAYOUT_SIMPLE);
+	if(!model.loadProgram(file))
+	{
+		out << "export: program did not load\n";
+		return false;
+	}
+	Coord min, max;
+	model.getLayoutBounds(min, max);
+	int width = (int)((max.x - min.x + 10) * FrameExporter::DEFAULT_SCALE + 0.5);
+	int height = (int)((max.y - min.y + 10) * FrameExporter::DEFAULT_SCALE + 0.5);
+
+	wxFileName prefix(wxFileName::GetTempDir(), _T("selftest_export"));
+	FrameExporter exporter(LAYOUT_SIMPLE);
+	luint frames = exporter.exportProgram(file, prefix.GetFullPath());
+	luint expected = STRAIGHT_LENGTH * Component::simpleClockSteps + 1;
+	bool passed = true;
+	if(frames != expected)
+	{
+		out << "export: " << frames << " frames, expected " << expected << "\n";
+		passed = false;
+	}
+	std::string base((const char*)prefix.GetFullPath().mb_str());
+	for(luint i = 0; i < frames; i++)
+	{
+		char number[16];
+		std::snprintf(number, sizeof(number), "_%05lu.png", (unsigned long)i);
+		wxString name((base + number).c_str(), wxConvUTF8);
+		wxImage image;
+		if(!image.LoadFile(name, wxBITMAP_TYPE_PNG))
+		{
+			out << "export: " << base << number << " was not written\n";
+			passed = false;
+		}
+		else if(image.GetWidth() != width || image.GetHeight() != height)
+		{
+			out << "export: " << base << number << " is " << image.GetWidth() << "x" << image.GetHeight()
+				<< ", expected " << width << "x" << height << "\n";
+			passed = false;
+		}
+		wxRemoveFile(name);
+	}
+	wxRemoveFile(file);
+	return passed;
+}
+
+// Batch runs must stop once a program has run past its end, with the same
+// state as a model stepped on well beyond it, and never stop a program that
+// loops for ever.
+bool SelfTest::testBatchEnd(std::ostream& out)
+{
+	struct Case
+	{
+		const char* name;
+		const char* program;
+		bool finishes;
+	};
+	const Case cases[] = {
+		{ "trailing branch", TRAILING_BRANCH_PROGRAM, true },
+		{ "forward branch", FORWARD_BRANCH_PROGRAM, true },
+		{ "loop", LOOP_PROGRAM, false }
+	};
+	const Layout layouts[] = { LAYOUT_SIMPLE, LAYOUT_PIPELINE, LAYOUT_FORWARDING };
+	const luint maxCycles = 500;
+	bool passed = true;
+	for(auto&& c : cases)
+	{
+		wxString file = writeProgram(_T("selftest_end"), c.program);
+		for(auto&& layout : layouts)
+		{
+			BatchRunner runner(layout, maxCycles, 1);
+			runner.addFile(file);
+			runner.run();
+			const BatchResult& result = runner.getResults()[0];
+			if(!result.valid || result.finished != c.finishes)
+			{
+				out << "batch end: " << c.name << " in layout " << layout << (result.finished ? " finished" : " did not finish")
+					<< " after " << result.cycles << " cycles\n";
+				passed = false;
+				continue;
+			}
+			if(!c.finishes)
+			{
+				if(result.cycles != maxCycles)
+				{
+					out << "batch end: " << c.name << " in layout " << layout << " stopped after " << result.cycles
+						<< " of " << maxCycles << " cycles\n";
+					passed = false;
+				}
+				continue;
+			}
+			Model direct;
+			direct.resetup(layout);
+			direct.loadProgram(file);
+			for(uint i = 0; i < 100 * Component::simpleClockSteps; i++)
+			{
+				direct.step();
+			}
+			bool same = true;
+			for(uint i = 0; i < Model::MAX_REGISTERS; i++)
+			{
+				same = same && result.registers[i] == direct.getMemoryData(ID_REGISTER_LIST, i);
+			}
+			for(uint i = 0; i < Model::MAX_DATA; i++)
+			{
+				same = same && result.data[i] == direct.getMemoryData(ID_DATA_LIST, i);
+			}
+			if(!same)
+			{
+				out << "batch end: " << c.name << " in layout " << layout << " stopped after " << result.cycles
+					<< " cycles with a different state from stepping on\n";
+				passed = false;
+			}
+		}
+		wxRemoveFile(file);
+	}
+	return passed;
+}
+
+// Load one file into many fresh models, as batch runs and exports do. Every
+// load must assemble the same words, whatever memory the scanner was given.
+bool SelfTest::testRepeatedLoad(std::ostream& out)
+{
+	wxString file = writeProgram(_T("selftest_registers"), REGISTERS_PROGRAM);
+	uint failures = 0;
+	for(uint run = 0; run < 300; run++)
+	{
+		{
+			// Leave digits in the memory the next scanner is likely to get,
+			// so reading past a character shows up as wrong numbers.
+			std::unique_ptr<char[]> dirty(new char[sizeof(Scanner)]);
+			std::memset(dirty.get(), '7', sizeof(Scanner));
+		}
+		Model model;
+		model.resetup(LAYOUT_FORWARDING);
+		bool same = model.loadProgram(file);
+		for(uint i = 0; same && i < sizeof(REGISTERS_WORDS) / sizeof(REGISTERS_WORDS[0]); i++)
+		{
+			same = (model.getMemoryData(ID_INSTRUCTION_LIST, 4 * i) == REGISTERS_WORDS[i]);
+		}
+		if(!same)
+		{
+			failures++;
+		}
+	}
+	wxRemoveFile(file);
+	if(failures != 0)
+	{
+		out << "repeated load: " << failures << " of 300 loads assembled the wrong words\n";
+		return false;
+	}
+	return true;
+}
+
+wxString SelfTest::writeProgram(wxString name, const char* text)
+{
+	wxFileName file(wxFileName::GetTempDir(), name, _T("def"));
+	std::ofstream out(file.GetFullPath().fn_str());
+	out << text;
+	return file.GetFullPath();
+}
@@ -0,0 +1,55 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef SELFTEST_H_
+#define SELFTEST_H_
+
+#include <ostream>
+
+#include <wx/string.h>
+
+#include "Types.h"
+
+// Checks of the parts that run off the GUI thread or without a window,
+// run with --self-test. Each test writes what failed to out.
+class SelfTest
+{
+	public:
+		// Run every test. Returns false if any failed.
+		bool run(std::ostream& out);
+	private:
+		bool testWorkerRestart(std::ostream& out);
+		bool testExport(std::ostream& out);
+		bool testBatchEnd(std::ostream& out);
+		bool testRepeatedLoad(std::ostream& out);
+		// Write text to a temporary program file named name.def.
+		static wxString writeProgram(wxString name, const char* text);
+		static const char* LOOP_PROGRAM;
+		static const char* STRAIGHT_PROGRAM;
+		static const luint STRAIGHT_LENGTH;
+		static const char* TRAILING_BRANCH_PROGRAM;
+		static const char* FORWARD_BRANCH_PROGRAM;
+		static const char* REGISTERS_PROGRAM;
+		static const luint REGISTERS_WORDS[];
+};
+
+#endif /*SELFTEST_H_*/
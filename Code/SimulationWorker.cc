@@ -0,0 +1,110 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <chrono>
+
+#include "SimulationWorker.h"
+
+SimulationWorker::SimulationWorker()
+	: stopRequested(false), stopped(false), back(0), front(1), middle(2)
+{
+}
+
+SimulationWorker::~SimulationWorker()
+{
+	stopRequested = true;
+	if(thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+void SimulationWorker::start(Model& model)
+{
+	if(!runner)
+	{
+		runner = std::make_unique<Model>();
+	}
+	runner->copySimulation(model);
+	runner->setTimingStats(model.getTimingStats());
+	stopRequested = false;
+	stopped = false;
+	// The slots must be distinct again, whatever the last run left them as.
+	back = 0;
+	front = 1;
+	middle = 2;
+	thread = std::thread(&SimulationWorker::work, this);
+}
+
+void SimulationWorker::work()
+{
+	const std::chrono::milliseconds interval(PUBLISH_MS);
+	auto lastPublish = std::chrono::steady_clock::now();
+	while(!stopRequested.load(std::memory_order_relaxed))
+	{
+		runner->run(CHUNK_CYCLES);
+		if(runner->atBreakpoint())
+		{
+			publish();
+			stopped.store(true, std::memory_order_release);
+			return;
+		}
+		auto now = std::chrono::steady_clock::now();
+		if(now - lastPublish >= interval)
+		{
+			publish();
+			lastPublish = now;
+		}
+	}
+}
+
+void SimulationWorker::publish()
+{
+	runner->takeSnapshot(snapshots[back]);
+	back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+bool SimulationWorker::update(Model& model)
+{
+	if(!(middle.load(std::memory_order_relaxed) & FRESH))
+	{
+		return false;
+	}
+	front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+	model.loadSnapshot(snapshots[front]);
+	return true;
+}
+
+void SimulationWorker::stop(Model& model)
+{
+	if(!thread.joinable())
+	{
+		return;
+	}
+	stopRequested = true;
+	thread.join();
+	// The worker may have stepped past the last snapshot, so take the
+	// final state from the copy itself.
+	runner->takeSnapshot(snapshots[back]);
+	model.loadSnapshot(snapshots[back]);
+	model.getHistory() = runner->getHistory();
+}
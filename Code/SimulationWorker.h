@@ -0,0 +1,70 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef SIMULATIONWORKER_H_
+#define SIMULATIONWORKER_H_
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "Types.h"
+#include "Model.h"
+
+// Runs a copy of a model on its own thread so long runs do not hold up
+// the GUI. Every few milliseconds the worker takes a snapshot of the copy
+// between steps and publishes it through a lock-free triple buffer: the
+// worker fills the back slot and swaps it with the middle one, the GUI
+// swaps the middle slot with its front one when it is newer. Neither side
+// ever waits and the GUI only sees whole steps.
+class SimulationWorker
+{
+	public:
+		SimulationWorker();
+		~SimulationWorker();
+		// Copy model and start running the copy.
+		void start(Model& model);
+		// Load the latest snapshot into model. Returns false if nothing new
+		// was published since the last call.
+		bool update(Model& model);
+		// Stop the run and hand its final state and history to model.
+		void stop(Model& model);
+		bool isRunning(){ return thread.joinable(); };
+		// The run stopped by itself at a breakpoint.
+		bool hasStopped(){ return stopped.load(std::memory_order_acquire); };
+		static const uint CHUNK_CYCLES = 64;	// Cycles between checks for a stop request.
+		static const uint PUBLISH_MS = 10;		// Time between snapshots.
+	private:
+		void work();
+		void publish();
+		std::unique_ptr<Model> runner;
+		std::thread thread;
+		std::atomic<bool> stopRequested;
+		std::atomic<bool> stopped;
+		ModelSnapshot snapshots[3];
+		uint back;					// Slot the worker writes, only used by the worker.
+		uint front;					// Slot the GUI reads, only used by the GUI.
+		std::atomic<uint> middle;	// Slot last published, with FRESH set until it is taken.
+		static const uint FRESH = 4;
+};
+
+#endif /*SIMULATIONWORKER_H_*/
@@ -0,0 +1,139 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <algorithm>
+#include <cmath>
+
+#include "SpatialIndex.h"
+
+SpatialIndex::SpatialIndex()
+{
+	clear();
+}
+
+void SpatialIndex::clear()
+{
+	rects.clear();
+	cellStart.assign(2, 0);
+	cellItems.clear();
+	originX = 0;
+	originY = 0;
+	cellWidth = 1;
+	cellHeight = 1;
+	columns = 1;
+	rows = 1;
+}
+
+uint SpatialIndex::insert(double left, double bottom, double right, double top)
+{
+	Rect r = {left, bottom, right, top};
+	rects.push_back(r);
+	return rects.size() - 1;
+}
+
+void SpatialIndex::build()
+{
+	if(rects.empty())
+	{
+		clear();
+		return;
+	}
+	double maxX = rects[0].right;
+	double maxY = rects[0].top;
+	originX = rects[0].left;
+	originY = rects[0].bottom;
+	for(auto&& r : rects)
+	{
+		originX = std::min(originX, r.left);
+		originY = std::min(originY, r.bottom);
+		maxX = std::max(maxX, r.right);
+		maxY = std::max(maxY, r.top);
+	}
+	// Roughly one rectangle per cell.
+	columns = rows = std::max((uint)1, (uint)std::ceil(std::sqrt((double)rects.size())));
+	cellWidth = std::max((maxX - originX) / columns, 1e-6);
+	cellHeight = std::max((maxY - originY) / rows, 1e-6);
+
+	// Count the rectangles in each cell, then fill them in insertion order.
+	cellStart.assign(columns * rows + 1, 0);
+	for(int pass = 0; pass < 2; ++pass)
+	{
+		std::vector<uint> next(cellStart.begin(), cellStart.end() - 1);
+		for(uint i = 0; i < rects.size(); ++i)
+		{
+			const Rect& r = rects[i];
+			for(uint row = getRow(r.bottom); row <= getRow(r.top); ++row)
+			{
+				for(uint col = getColumn(r.left); col <= getColumn(r.right); ++col)
+				{
+					uint cell = row * columns + col;
+					if(pass == 0)
+					{
+						++cellStart[cell + 1];
+					}
+					else
+					{
+						cellItems[next[cell]++] = i;
+					}
+				}
+			}
+		}
+		if(pass == 0)
+		{
+			for(uint cell = 0; cell < columns * rows; ++cell)
+			{
+				cellStart[cell + 1] += cellStart[cell];
+			}
+			cellItems.resize(cellStart.back());
+		}
+	}
+}
+
+uint SpatialIndex::find(double x, double y) const
+{
+	if(x < originX || y < originY)
+	{
+		return NOT_FOUND;
+	}
+	uint cell = getRow(y) * columns + getColumn(x);
+	for(uint n = cellStart[cell]; n < cellStart[cell + 1]; ++n)
+	{
+		const Rect& r = rects[cellItems[n]];
+		if(r.left < x && r.right > x && r.bottom < y && r.top > y)
+		{
+			return cellItems[n];
+		}
+	}
+	return NOT_FOUND;
+}
+
+uint SpatialIndex::getColumn(double x) const
+{
+	double col = std::floor((x - originX) / cellWidth);
+	return (uint)std::min(std::max(col, 0.0), (double)(columns - 1));
+}
+
+uint SpatialIndex::getRow(double y) const
+{
+	double row = std::floor((y - originY) / cellHeight);
+	return (uint)std::min(std::max(row, 0.0), (double)(rows - 1));
+}
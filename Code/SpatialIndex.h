@@ -0,0 +1,67 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef SPATIAL_INDEX_H_
+#define SPATIAL_INDEX_H_
+
+#include <vector>
+
+#include "Types.h"
+
+// Uniform grid of rectangles for point queries. Rectangles are numbered in
+// the order they are inserted, and a query returns the lowest number, so
+// results match a linear scan in insertion order.
+class SpatialIndex
+{
+	public:
+		SpatialIndex();
+		void clear();
+		uint insert(double left, double bottom, double right, double top);
+		// Sort the rectangles into grid cells. Call after the last insert.
+		void build();
+		// First rectangle strictly containing (x, y), or NOT_FOUND.
+		uint find(double x, double y) const;
+		uint size() const { return rects.size(); };
+		static const uint NOT_FOUND = ~((uint)0);
+	private:
+		struct Rect
+		{
+			double left;
+			double bottom;
+			double right;
+			double top;
+		};
+		uint getColumn(double x) const;
+		uint getRow(double y) const;
+		std::vector<Rect> rects;
+		// Rectangles of cell n are cellItems[cellStart[n]] up to cellItems[cellStart[n + 1]].
+		std::vector<uint> cellStart;
+		std::vector<uint> cellItems;
+		double originX;
+		double originY;
+		double cellWidth;
+		double cellHeight;
+		uint columns;
+		uint rows;
+};
+
+#endif /*SPATIAL_INDEX_H_*/
@@ -0,0 +1,142 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(uint numThreads)
+{
+	if(numThreads == 0)
+	{
+		numThreads = std::thread::hardware_concurrency();
+	}
+	if(numThreads == 0)
+	{
+		numThreads = 1;
+	}
+	queued = 0;
+	pending = 0;
+	nextQueue = 0;
+	stopping = false;
+	for(uint i = 0; i < numThreads; i++)
+	{
+		queues.push_back(std::make_unique<Queue>());
+	}
+	for(uint i = 0; i < numThreads; i++)
+	{
+		threads.emplace_back(&ThreadPool::work, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	taskAdded.notify_all();
+	for(auto&& i : threads)
+	{
+		i.join();
+	}
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+	uint index;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		index = nextQueue;
+		nextQueue = (nextQueue + 1) % queues.size();
+		pending++;
+	}
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->mutex);
+		queues[index]->tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued++;
+	}
+	taskAdded.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	allDone.wait(lock, [this]{ return pending == 0; });
+}
+
+void ThreadPool::work(uint index)
+{
+	std::function<void()> task;
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			taskAdded.wait(lock, [this]{ return stopping || queued > 0; });
+			if(queued == 0)
+			{
+				return;
+			}
+			// Claim a task now so other workers do not wake up for it.
+			queued--;
+		}
+		// The claimed task is in some queue, keep looking until it is found.
+		while(!takeTask(index, task))
+		{
+			std::this_thread::yield();
+		}
+		task();
+		task = nullptr;
+		std::lock_guard<std::mutex> lock(mutex);
+		if(--pending == 0)
+		{
+			allDone.notify_all();
+		}
+	}
+}
+
+bool ThreadPool::takeTask(uint index, std::function<void()>& task)
+{
+	{
+		Queue& own = *queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if(!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+	for(uint i = 1; i < queues.size(); i++)
+	{
+		Queue& other = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(other.mutex);
+		if(!other.tasks.empty())
+		{
+			task = std::move(other.tasks.front());
+			other.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,69 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Types.h"
+
+// Fixed set of worker threads, each with its own task queue. Tasks are
+// handed out round robin; a worker takes the newest task from its own
+// queue and, when that is empty, steals the oldest task from another, so
+// long tasks do not leave the other workers idle.
+class ThreadPool
+{
+	public:
+		// 0 threads uses one per hardware thread.
+		ThreadPool(uint numThreads = 0);
+		~ThreadPool();
+		void submit(std::function<void()> task);
+		// Block until every task submitted so far has finished.
+		void wait();
+		uint getNumThreads(){ return threads.size(); };
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+		void work(uint index);
+		bool takeTask(uint index, std::function<void()>& task);
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable taskAdded;
+		std::condition_variable allDone;
+		uint queued;	// Tasks waiting in a queue.
+		uint pending;	// Tasks submitted and not yet finished.
+		uint nextQueue;
+		bool stopping;
+};
+
+#endif /*THREADPOOL_H_*/
@@ -0,0 +1,96 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#include <algorithm>
+
+#include "TimingStats.h"
+
+TimingStats::TimingStats()
+{
+	for(auto&& ring : rings)
+	{
+		for(auto&& sample : ring.samples)
+		{
+			sample = 0;
+		}
+		ring.next = 0;
+	}
+}
+
+void TimingStats::record(TimingName name, luint nanoseconds)
+{
+	Ring& ring = rings[name];
+	luint i = ring.next.fetch_add(1, std::memory_order_relaxed);
+	ring.samples[i % NUM_SAMPLES].store(nanoseconds, std::memory_order_relaxed);
+}
+
+uint TimingStats::getNumSamples(Ring& ring)
+{
+	return (uint)std::min<luint>(ring.next.load(std::memory_order_relaxed), NUM_SAMPLES);
+}
+
+double TimingStats::getAverage(TimingName name)
+{
+	Ring& ring = rings[name];
+	uint count = getNumSamples(ring);
+	if(count == 0)
+	{
+		return 0;
+	}
+	luint total = 0;
+	for(uint i = 0; i < count; i++)
+	{
+		total += ring.samples[i].load(std::memory_order_relaxed);
+	}
+	return total / 1e6 / count;
+}
+
+double TimingStats::getMaximum(TimingName name)
+{
+	Ring& ring = rings[name];
+	uint count = getNumSamples(ring);
+	luint maximum = 0;
+	for(uint i = 0; i < count; i++)
+	{
+		maximum = std::max(maximum, ring.samples[i].load(std::memory_order_relaxed));
+	}
+	return maximum / 1e6;
+}
+
+const char* TimingStats::getName(TimingName name)
+{
+	switch(name)
+	{
+		case TIMING_STEP:
+			return "Step";
+		case TIMING_DRAW:
+			return "Draw";
+		case TIMING_PAINT:
+			return "Paint";
+		case TIMING_DATA_LIST:
+			return "Lists";
+		case TIMING_HIGHLIGHTING:
+			return "Highlighting";
+		default:
+			return "";
+	}
+}
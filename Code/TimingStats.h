@@ -0,0 +1,90 @@
+/*
+ *  
+ *  MIPS-Datapath - Graphical MIPS CPU Simulator.
+ *  Copyright 2008, 2012 Andrew Gascoyne-Cecil.
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ *  Contact: gascoyne+mips@gmail.com
+ * 
+ */
+ 
+#ifndef TIMINGSTATS_H_
+#define TIMINGSTATS_H_
+
+#include <atomic>
+#include <chrono>
+
+#include "Types.h"
+
+enum TimingName
+{
+	TIMING_STEP,			// Model::step().
+	TIMING_DRAW,			// Model::draw() into the geometry cache.
+	TIMING_PAINT,			// A whole canvas repaint, including GL.
+	TIMING_DATA_LIST,		// Frame::updateDataList().
+	TIMING_HIGHLIGHTING,	// Frame::updateDataListHighlighting().
+	TIMING_MAX
+};
+
+// Rolling record of how long recent calls took, for the timing overlay.
+// Each timing keeps its latest NUM_SAMPLES durations in a ring. Samples
+// may be added from any thread without locking; a reader sees each sample
+// whole but may miss one that is being written.
+class TimingStats
+{
+	public:
+		TimingStats();
+		void record(TimingName name, luint nanoseconds);
+		// Over the samples in the ring, in milliseconds.
+		double getAverage(TimingName name);
+		double getMaximum(TimingName name);
+		static const char* getName(TimingName name);
+		static const uint NUM_SAMPLES = 128;
+	private:
+		struct Ring
+		{
+			std::atomic<luint> samples[NUM_SAMPLES];
+			std::atomic<luint> next;	// Samples ever recorded.
+		};
+		uint getNumSamples(Ring& ring);
+		Ring rings[TIMING_MAX];
+};
+
+// Records the time from construction to destruction. Does nothing when
+// stats is null, so timing can be left in place at the cost of a test.
+class ScopedTiming
+{
+	public:
+		ScopedTiming(TimingStats* stats, TimingName name) : stats(stats), name(name)
+		{
+			if(stats)
+			{
+				start = std::chrono::steady_clock::now();
+			}
+		};
+		~ScopedTiming()
+		{
+			if(stats)
+			{
+				stats->record(name, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+			}
+		};
+	private:
+		TimingStats* stats;
+		TimingName name;
+		std::chrono::steady_clock::time_point start;
+};
+
+#endif /*TIMINGSTATS_H_*/